@@ -0,0 +1,82 @@
+#include "EntityManager.h"
+#include "SpatialGrid.h"
+
+#include <benchmark/benchmark.h>
+#include <random>
+
+namespace
+{
+	constexpr float	width = 1440.0f;
+	constexpr float	height = 900.0f;
+	constexpr float	cellSize = 64.0f;
+
+	void	spawn(EntityManager& entities, std::mt19937& gen, const EntityTag tag, const int64_t count, const float radius)
+	{
+		std::uniform_real_distribution<float> posX(0.0f, width);
+		std::uniform_real_distribution<float> posY(0.0f, height);
+
+		for (int64_t i = 0; i < count; ++i)
+		{
+			auto entity = entities.addEntity(tag);
+			entity.addComponent<TransformComponent>(Vec2f{posX(gen), posY(gen)}, Vec2f{}, 0.0f);
+			entity.addComponent<CollisionComponent>(radius);
+		}
+	}
+
+	// The bullet-vs-enemy loop of Game::collisionSystem: gather targets, optionally
+	// build the grid, then test every bullet against its candidates. Hits are
+	// counted rather than resolved so every iteration sees the same world.
+	void	BM_BulletCollision(benchmark::State& state, const bool useGrid)
+	{
+		std::mt19937 gen{42};
+		EntityManager entities;
+		spawn(entities, gen, EntityTag::Bullet, state.range(0), 10.0f);
+		spawn(entities, gen, EntityTag::Enemy, state.range(1), 25.0f);
+		entities.update();
+
+		const auto& all = entities.getEntities();
+		const auto& bullets = entities.getEntities(EntityTag::Bullet);
+		std::vector<uint32_t> targets;
+		std::vector<uint32_t> scratch;
+		SpatialGrid grid;
+		for (auto _ : state)
+		{
+			targets.clear();
+			for (uint32_t i = 0; i < all.size(); ++i)
+			{
+				if (all[i].tag() == EntityTag::Enemy) { targets.push_back(i); }
+			}
+			if (useGrid)
+			{
+				grid.reset(width, height, cellSize);
+				for (const auto index : targets)
+				{
+					grid.insert(index, all[index].getComponent<TransformComponent>().pos_, all[index].getComponent<CollisionComponent>().radius_);
+				}
+				grid.build();
+			}
+
+			size_t hits = 0;
+			for (const auto& bullet : bullets)
+			{
+				const Vec2f bulletPos = bullet.getComponent<TransformComponent>().pos_;
+				const float bulletRadius = bullet.getComponent<CollisionComponent>().radius_;
+				if (useGrid) { grid.query(bulletPos, bulletRadius, scratch); }
+				for (const auto index : useGrid ? scratch : targets)
+				{
+					const auto collisionRadius = all[index].getComponent<CollisionComponent>().radius_;
+					if (bulletPos.distSquared(all[index].getComponent<TransformComponent>().pos_) <
+						(bulletRadius + collisionRadius) * (bulletRadius + collisionRadius))
+					{
+						++hits;
+					}
+				}
+			}
+			benchmark::DoNotOptimize(hits);
+		}
+		state.SetItemsProcessed(state.iterations() * state.range(0));
+	}
+}
+
+BENCHMARK_CAPTURE(BM_BulletCollision, BruteForce, false)->ArgsProduct({{10, 100, 1000}, {10, 100, 1000}});
+BENCHMARK_CAPTURE(BM_BulletCollision, Grid, true)->ArgsProduct({{10, 100, 1000, 10000}, {10, 100, 1000, 10000}});
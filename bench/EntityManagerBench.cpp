@@ -0,0 +1,70 @@
+#include "EntityManager.h"
+
+#include <benchmark/benchmark.h>
+
+namespace
+{
+	// Keeps state.range(0) entities alive and replaces state.range(1) percent of
+	// them every frame, the same add/destroy/update cycle bullets go through.
+	void	BM_EntityChurn(benchmark::State& state)
+	{
+		const auto alive = static_cast<size_t>(state.range(0));
+		const auto churn = alive * static_cast<size_t>(state.range(1)) / 100;
+
+		EntityManager entities;
+		for (size_t i = 0; i < alive; ++i) { entities.addEntity(EntityTag::Bullet); }
+		entities.update();
+
+		size_t cursor = 0;
+		for (auto _ : state)
+		{
+			const auto& vec = entities.getEntities();
+			for (size_t i = 0; i < churn; ++i) { vec[(cursor + i) % vec.size()].destroy(); }
+			cursor += churn;
+			for (size_t i = 0; i < churn; ++i)
+			{
+				entities.addEntity(EntityTag::Bullet).addComponent<TransformComponent>(Vec2f{}, Vec2f{1.0f, 1.0f}, 0.0f);
+			}
+			entities.update();
+			benchmark::DoNotOptimize(entities.getEntities().data());
+		}
+		state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(churn));
+	}
+
+	void	BM_AddEntity(benchmark::State& state)
+	{
+		const auto count = static_cast<size_t>(state.range(0));
+
+		EntityManager entities;
+		for (auto _ : state)
+		{
+			for (size_t i = 0; i < count; ++i) { entities.addEntity(EntityTag::Enemy); }
+			entities.update();
+
+			state.PauseTiming();
+			for (const auto& entity : entities.getEntities()) { entity.destroy(); }
+			entities.update();
+			state.ResumeTiming();
+		}
+		state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(count));
+	}
+
+	// update() with nothing to add and nothing dead: the cost of the remove passes alone.
+	void	BM_UpdateSteady(benchmark::State& state)
+	{
+		EntityManager entities;
+		for (int64_t i = 0; i < state.range(0); ++i) { entities.addEntity(EntityTag::Enemy); }
+		entities.update();
+
+		for (auto _ : state)
+		{
+			entities.update();
+			benchmark::DoNotOptimize(entities.getEntities().data());
+		}
+		state.SetItemsProcessed(state.iterations() * state.range(0));
+	}
+}
+
+BENCHMARK(BM_EntityChurn)->ArgsProduct({{1000, 10000, 100000}, {1, 10, 50}});
+BENCHMARK(BM_AddEntity)->Arg(1000)->Arg(10000)->Arg(100000);
+BENCHMARK(BM_UpdateSteady)->Arg(1000)->Arg(10000)->Arg(100000);
@@ -0,0 +1,72 @@
+#include "MotionKernels.h"
+
+#include <benchmark/benchmark.h>
+#include <random>
+
+namespace
+{
+	constexpr float	width = 1440.0f;
+	constexpr float	height = 900.0f;
+
+	MotionBuffer	makeBodies(const size_t count)
+	{
+		std::mt19937 gen{42};
+		std::uniform_real_distribution<float> posX(0.0f, width);
+		std::uniform_real_distribution<float> posY(0.0f, height);
+		std::uniform_real_distribution<float> speed(-5.0f, 5.0f);
+
+		MotionBuffer buffer;
+		for (size_t i = 0; i < count; ++i)
+		{
+			buffer.push(posX(gen), posY(gen), speed(gen), speed(gen), 25.0f);
+		}
+
+		return (buffer);
+	}
+
+	void	BM_IntegrateAndBounce(benchmark::State& state, const MotionKernels::Isa isa)
+	{
+		if (!MotionKernels::setIsa(isa))
+		{
+			state.SkipWithError("instruction set not supported by this CPU");
+			return ;
+		}
+
+		auto bodies = makeBodies(static_cast<size_t>(state.range(0)));
+		const MotionBatch batch = bodies.batch(0, bodies.size());
+		for (auto _ : state)
+		{
+			MotionKernels::integrateAndBounce(batch, width, height);
+			benchmark::ClobberMemory();
+		}
+		state.SetItemsProcessed(state.iterations() * state.range(0));
+		MotionKernels::setIsa(MotionKernels::detectIsa());
+	}
+
+	void	BM_Integrate(benchmark::State& state, const MotionKernels::Isa isa)
+	{
+		if (!MotionKernels::setIsa(isa))
+		{
+			state.SkipWithError("instruction set not supported by this CPU");
+			return ;
+		}
+
+		auto bodies = makeBodies(static_cast<size_t>(state.range(0)));
+		const MotionBatch batch = bodies.batch(0, bodies.size());
+		for (auto _ : state)
+		{
+			MotionKernels::integrate(batch);
+			benchmark::ClobberMemory();
+		}
+		state.SetItemsProcessed(state.iterations() * state.range(0));
+		MotionKernels::setIsa(MotionKernels::detectIsa());
+	}
+}
+
+BENCHMARK_CAPTURE(BM_IntegrateAndBounce, Scalar, MotionKernels::Isa::Scalar)->Arg(1000)->Arg(10000)->Arg(100000);
+BENCHMARK_CAPTURE(BM_IntegrateAndBounce, SSE2, MotionKernels::Isa::SSE2)->Arg(1000)->Arg(10000)->Arg(100000);
+BENCHMARK_CAPTURE(BM_IntegrateAndBounce, AVX2, MotionKernels::Isa::AVX2)->Arg(1000)->Arg(10000)->Arg(100000);
+
+BENCHMARK_CAPTURE(BM_Integrate, Scalar, MotionKernels::Isa::Scalar)->Arg(1000)->Arg(10000)->Arg(100000);
+BENCHMARK_CAPTURE(BM_Integrate, SSE2, MotionKernels::Isa::SSE2)->Arg(1000)->Arg(10000)->Arg(100000);
+BENCHMARK_CAPTURE(BM_Integrate, AVX2, MotionKernels::Isa::AVX2)->Arg(1000)->Arg(10000)->Arg(100000);
@@ -0,0 +1,43 @@
+#include "RandomGenerator.h"
+
+#include <benchmark/benchmark.h>
+
+namespace
+{
+	void	BM_RandomEnemyPos(benchmark::State& state)
+	{
+		const GameConfig gameConfig;
+		RandomGenerator random{42};
+		const Vec2f playerPos{720.0f, 450.0f};
+		for (auto _ : state) { benchmark::DoNotOptimize(random.getRandomEnemyPos(gameConfig, playerPos)); }
+		state.SetItemsProcessed(state.iterations());
+	}
+
+	void	BM_RandomEnemySpeed(benchmark::State& state)
+	{
+		const GameConfig gameConfig;
+		RandomGenerator random{42};
+		for (auto _ : state) { benchmark::DoNotOptimize(random.getRandomEnemySpeed(gameConfig)); }
+		state.SetItemsProcessed(state.iterations());
+	}
+
+	void	BM_RandomEnemyColor(benchmark::State& state)
+	{
+		RandomGenerator random{42};
+		for (auto _ : state) { benchmark::DoNotOptimize(random.getRandomEnemyColor()); }
+		state.SetItemsProcessed(state.iterations());
+	}
+
+	void	BM_RandomEnemyPointCount(benchmark::State& state)
+	{
+		const GameConfig gameConfig;
+		RandomGenerator random{42};
+		for (auto _ : state) { benchmark::DoNotOptimize(random.getRandomEnemyPointCount(gameConfig)); }
+		state.SetItemsProcessed(state.iterations());
+	}
+}
+
+BENCHMARK(BM_RandomEnemyPos);
+BENCHMARK(BM_RandomEnemySpeed);
+BENCHMARK(BM_RandomEnemyColor);
+BENCHMARK(BM_RandomEnemyPointCount);
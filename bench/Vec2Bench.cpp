@@ -0,0 +1,57 @@
+#include "Vec2.h"
+
+#include <benchmark/benchmark.h>
+#include <random>
+#include <vector>
+
+namespace
+{
+	constexpr size_t	pointCount = 4096;
+
+	std::vector<Vec2f>	makePoints()
+	{
+		std::mt19937 gen{42};
+		std::uniform_real_distribution<float> coord(-1000.0f, 1000.0f);
+
+		std::vector<Vec2f> points(pointCount);
+		for (auto& point : points) { point = Vec2f{coord(gen), coord(gen)}; }
+
+		return (points);
+	}
+
+	void	BM_Vec2Normalize(benchmark::State& state)
+	{
+		const auto points = makePoints();
+		for (auto _ : state)
+		{
+			for (const auto& point : points) { benchmark::DoNotOptimize(point.normalized()); }
+		}
+		state.SetItemsProcessed(state.iterations() * pointCount);
+	}
+
+	void	BM_Vec2Dist(benchmark::State& state)
+	{
+		const auto points = makePoints();
+		const Vec2f origin{720.0f, 450.0f};
+		for (auto _ : state)
+		{
+			for (const auto& point : points) { benchmark::DoNotOptimize(origin.dist(point)); }
+		}
+		state.SetItemsProcessed(state.iterations() * pointCount);
+	}
+
+	void	BM_Vec2DistSquared(benchmark::State& state)
+	{
+		const auto points = makePoints();
+		const Vec2f origin{720.0f, 450.0f};
+		for (auto _ : state)
+		{
+			for (const auto& point : points) { benchmark::DoNotOptimize(origin.distSquared(point)); }
+		}
+		state.SetItemsProcessed(state.iterations() * pointCount);
+	}
+}
+
+BENCHMARK(BM_Vec2Normalize);
+BENCHMARK(BM_Vec2Dist);
+BENCHMARK(BM_Vec2DistSquared);
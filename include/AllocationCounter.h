@@ -0,0 +1,93 @@
+#ifndef ALLOCATION_COUNTER_H
+# define ALLOCATION_COUNTER_H
+
+# include <array>
+# include <cstddef>
+# include <cstdint>
+
+// Subsystem an allocation is charged to. MemoryScope sets the tag for the
+// current thread; jobs inherit the tag of the thread that queued them.
+enum class MemoryTag : uint8_t
+{
+	Other,
+	Entities,
+	Systems,
+	Sfml,
+	ImGui,
+	Count
+};
+
+constexpr size_t	memoryTagCount = static_cast<size_t>(MemoryTag::Count);
+
+constexpr std::array<const char*, memoryTagCount>	memoryTagNames = {
+	"other",
+	"entities",
+	"systems",
+	"sfml",
+	"imgui"
+};
+
+struct MemoryStats
+{
+	uint64_t	allocations_ = 0;
+	size_t		liveBytes_ = 0;
+	size_t		peakBytes_ = 0;
+};
+
+// Counts calls to the global operator new, on every thread. Built in with
+// GEOMETRY_WARS_COUNT_ALLOCATIONS, which replaces operator new/delete; without it
+// count() stays 0. GEOMETRY_WARS_TRACK_MEMORY additionally prefixes every block
+// with its size and tag, so live and peak bytes can be kept per tag; without it
+// stats() and total() only carry allocation counts.
+class AllocationCounter
+{
+	public:
+# if defined(GEOMETRY_WARS_COUNT_ALLOCATIONS) || defined(GEOMETRY_WARS_TRACK_MEMORY)
+		static constexpr bool	enabled = true;
+# else
+		static constexpr bool	enabled = false;
+# endif
+# ifdef GEOMETRY_WARS_TRACK_MEMORY
+		static constexpr bool	tracking = true;
+# else
+		static constexpr bool	tracking = false;
+# endif
+
+		static uint64_t		count();
+		static MemoryStats	stats(const MemoryTag tag);
+		static MemoryStats	total();
+
+		static MemoryTag	currentTag();
+		// Returns the previous tag.
+		static MemoryTag	exchangeTag(const MemoryTag tag);
+};
+
+// Allocations made since construction.
+class AllocationScope
+{
+	public:
+		AllocationScope() :
+			start_{AllocationCounter::count()} {}
+
+		uint64_t	allocations() const { return (AllocationCounter::count() - start_); }
+
+	private:
+		uint64_t	start_;
+};
+
+// Charges this thread's allocations to tag until the end of the scope.
+class MemoryScope
+{
+	public:
+		explicit MemoryScope(const MemoryTag tag) :
+			previous_{AllocationCounter::exchangeTag(tag)} {}
+		~MemoryScope() { AllocationCounter::exchangeTag(previous_); }
+
+		MemoryScope(const MemoryScope&) = delete;
+		MemoryScope&	operator = (const MemoryScope&) = delete;
+
+	private:
+		MemoryTag	previous_;
+};
+
+#endif
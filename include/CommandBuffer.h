@@ -0,0 +1,98 @@
+#ifndef COMMAND_BUFFER_H
+# define COMMAND_BUFFER_H
+
+# include <cstdint>
+# include <utility>
+# include <variant>
+# include <vector>
+
+# include "Entity.h"
+# include "AllocationCounter.h"
+
+template<typename Tuple>
+struct VariantOf;
+
+template<typename... Ts>
+struct VariantOf<std::tuple<Ts...>> { using type = std::variant<Ts...>; };
+
+using ComponentVariant = VariantOf<ComponentTuple>::type;
+
+// Spawns, destroys and component additions recorded by one thread and applied
+// at EntityManager::update(). Commands are merged by order key, then by thread,
+// then by recording order: a parallel system that keys every unit of work (an
+// entity or chunk index) gets the same result whichever thread ran it, while a
+// serial system can leave the key at 0.
+class CommandBuffer
+{
+	friend class EntityManager;
+
+	public:
+		// Builds the components of an entity that does not exist yet. A reference
+		// returned by addComponent is only valid until the next spawn on this buffer.
+		class Spawn
+		{
+			friend class CommandBuffer;
+
+			public:
+				template<typename T, typename... TArgs>
+				T&	addComponent(TArgs&&... mArgs) const
+				{
+					auto& component = std::get<T>(buffer_->prototypes_[index_]);
+					component = T(std::forward<TArgs>(mArgs)...);
+					component.exists_ = true;
+
+					return (component);
+				}
+
+			private:
+				Spawn(CommandBuffer& buffer, const size_t index) :
+					buffer_{&buffer}, index_{index} {}
+
+				CommandBuffer*	buffer_;
+				size_t			index_;
+		};
+
+		void	setOrder(const uint64_t order) { order_ = order; }
+
+		Spawn	spawn(const EntityTag tag);
+		void	destroy(const Entity& entity);
+
+		template<typename T, typename... TArgs>
+		void	addComponent(const Entity& entity, TArgs&&... mArgs)
+		{
+			const MemoryScope scope{MemoryTag::Entities};
+			T component(std::forward<TArgs>(mArgs)...);
+			component.exists_ = true;
+			record(Command::AddComponent, EntityTag::Default, entity.handle(), components_.size());
+			components_.emplace_back(std::move(component));
+		}
+
+		bool	empty() const { return (commands_.empty()); }
+		void	clear();
+
+	private:
+		struct Command
+		{
+			enum Type : uint8_t
+			{
+				Spawn,
+				Destroy,
+				AddComponent
+			};
+
+			uint64_t		order_ = 0;
+			Type			type_ = Spawn;
+			EntityTag		tag_ = EntityTag::Default;
+			EntityHandle	handle_;
+			size_t			payload_ = 0;
+		};
+
+		void	record(const Command::Type type, const EntityTag tag, const EntityHandle handle, const size_t payload);
+
+		std::vector<Command>			commands_;
+		std::vector<ComponentTuple>		prototypes_;
+		std::vector<ComponentVariant>	components_;
+		uint64_t						order_ = 0;
+};
+
+#endif
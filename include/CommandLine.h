@@ -0,0 +1,35 @@
+#ifndef COMMAND_LINE_H
+# define COMMAND_LINE_H
+
+# include <cstdint>
+# include <optional>
+# include <string>
+
+struct LaunchOptions
+{
+	std::string			configPath_ = "config.json";
+	std::optional<bool>	headless_;
+	std::optional<int>	frames_;
+	std::optional<bool>	spatialGrid_;
+	std::optional<bool>	snapshots_;
+	std::optional<int>	workers_;
+	std::optional<uint64_t>	seed_;
+	std::optional<std::string>	recordPath_;
+	std::optional<std::string>	replayPath_;
+	std::optional<std::string>	scenarioPath_;
+	std::optional<std::string>	loadStatePath_;
+	std::optional<std::string>	reportPath_;
+};
+
+class CommandLine
+{
+	public:
+		static LaunchOptions	parse(int argc, char** argv);
+
+	private:
+		static int				parseInt(const std::string& option, const char* value);
+		static uint64_t			parseUnsigned(const std::string& option, const char* value);
+		static void				printUsage(const char* program);
+};
+
+#endif
\ No newline at end of file
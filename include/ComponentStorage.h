@@ -0,0 +1,68 @@
+#ifndef COMPONENT_STORAGE_H
+# define COMPONENT_STORAGE_H
+
+# include <array>
+# include <cstddef>
+# include <memory>
+# include <tuple>
+# include <vector>
+
+// Dense per-type component array split into fixed-size chunks.
+// Chunks are never reallocated, so references handed out by operator[] stay
+// valid while new entities are spawned in the middle of a system.
+template<typename T, size_t ChunkShift = 10>
+class ComponentArray
+{
+	public:
+		static constexpr size_t	chunkSize = size_t{1} << ChunkShift;
+
+		using Chunk = std::array<T, chunkSize>;
+
+		T&			operator[](const size_t slot) { return ((*chunks_[slot >> ChunkShift])[slot & (chunkSize - 1)]); }
+		const T&	operator[](const size_t slot) const { return ((*chunks_[slot >> ChunkShift])[slot & (chunkSize - 1)]); }
+
+		void		reserve(const size_t slots)
+		{
+			while (chunks_.size() * chunkSize < slots)
+			{
+				chunks_.push_back(std::make_unique<Chunk>());
+			}
+		}
+
+		size_t		chunkCount() const { return (chunks_.size()); }
+		Chunk&		chunk(const size_t index) { return (*chunks_[index]); }
+		size_t		capacity() const { return (chunks_.size() * chunkSize); }
+
+	private:
+		std::vector<std::unique_ptr<Chunk>>	chunks_;
+};
+
+template<typename Tuple>
+class ComponentStorage;
+
+// One ComponentArray per component type of the tuple, all indexed by the same entity slot.
+template<typename... Ts>
+class ComponentStorage<std::tuple<Ts...>>
+{
+	public:
+		template<typename T>
+		T&					get(const size_t slot) { return (std::get<ComponentArray<T>>(arrays_)[slot]); }
+
+		template<typename T>
+		const T&			get(const size_t slot) const { return (std::get<ComponentArray<T>>(arrays_)[slot]); }
+
+		template<typename T>
+		ComponentArray<T>&	array() { return (std::get<ComponentArray<T>>(arrays_)); }
+
+		void				reserve(const size_t slots) { (std::get<ComponentArray<Ts>>(arrays_).reserve(slots), ...); }
+
+		void				clear(const size_t slot) { ((get<Ts>(slot).exists_ = false), ...); }
+
+		size_t				capacity() const { return (std::get<0>(arrays_).capacity()); }
+		size_t				bytes() const { return (capacity() * (sizeof(Ts) + ...)); }
+
+	private:
+		std::tuple<ComponentArray<Ts>...>	arrays_;
+};
+
+#endif
\ No newline at end of file
@@ -1,7 +1,8 @@
 #ifndef COMPONENTS_H
 # define COMPONENTS_H
 
-# include <SFML/Graphics/CircleShape.hpp>
+# include <SFML/Graphics/Color.hpp>
+# include <cstddef>
 
 # include "Vec2.h"
 
@@ -14,27 +15,28 @@ struct TransformComponent : public Component
 {
 	Vec2f	pos_;
 	Vec2f	velocity_;
-	float	angle_;
+	float	angle_ = 0.0f;
+	Vec2f	prevPos_;
+	float	prevAngle_ = 0.0f;
 
 	TransformComponent() = default;
 	TransformComponent(const Vec2f& pos, const Vec2f& velocity, const float angle) :
-		pos_{pos}, velocity_{velocity}, angle_{angle} {}
+		pos_{pos}, velocity_{velocity}, angle_{angle}, prevPos_{pos}, prevAngle_{angle} {}
 };
 
 struct ShapeComponent : public Component
 {
-	sf::CircleShape	circle_;
+	float		radius_ = 0.0f;
+	size_t		pointCount_ = 0;
+	sf::Color	fillColor_;
+	sf::Color	outlineColor_;
+	float		outlineThickness_ = 0.0f;
 
 	ShapeComponent() = default;
 	ShapeComponent(const float radius, const size_t pointCount, const sf::Color& fillColor,
 					const sf::Color& outlineColor, const float thickness) :
-		circle_{radius, pointCount}
-	{
-		circle_.setFillColor(fillColor);
-		circle_.setOutlineColor(outlineColor);
-		circle_.setOutlineThickness(thickness);
-		circle_.setOrigin(radius, radius);
-	}
+		radius_{radius}, pointCount_{pointCount}, fillColor_{fillColor},
+		outlineColor_{outlineColor}, outlineThickness_{thickness} {}
 };
 
 struct CollisionComponent : public Component
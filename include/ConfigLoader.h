@@ -4,6 +4,7 @@
 # include <nlohmann/json.hpp>
 
 # include "GameConfig.h"
+# include "CommandLine.h"
 
 using json = nlohmann::json;
 
@@ -11,14 +12,23 @@ class ConfigLoader
 {
 	public:
 		static GameConfig	loadFromFile(const std::string& configPath);
+		static void			applyLaunchOptions(GameConfig& gameConfig, const LaunchOptions& options);
 
 	private:
 		static void			loadWindowConfig(WindowConfig& windowConfig, const json& window);
 		static void 		loadPlayerConfig(PlayerConfig& playerConfig, const json& player);
 		static void			loadEnemyConfig(EnemyConfig& enemyConfig, const json& enemy);
 		static void			loadBulletConfig(BulletConfig& bulletConfig, const json& bullet);
+		static void			loadParticleConfig(ParticleConfig& particleConfig, const json& particles);
 		static void			loadUIConfig(UIConfig& uiConfig, const json& ui);
 		static void			loadFont(Font& font, const json& ui);
+		static void			loadCollisionConfig(CollisionConfig& collisionConfig, const json& collision);
+		static void			loadSimulationConfig(SimulationConfig& simulationConfig, const json& simulation);
+		static void			loadScenarioFile(GameConfig& gameConfig, const std::string& scenarioPath);
+		static void			loadScenarioConfig(ScenarioConfig& scenarioConfig, const json& scenario);
+		static void			loadSpawnGroup(SpawnGroupConfig& group, const json& groupConfig);
+		static json			parseFile(const std::string& path, const char* kind);
+		static uint64_t		hashGameplay(json data);
 };
 
 #endif
\ No newline at end of file
@@ -1,37 +1,32 @@
 #ifndef ENTITY_H
 # define ENTITY_H
 
-# include "Components.h"
+# include "EntityPool.h"
 
-# include <string>
-# include <tuple>
+# include <cassert>
 
 class EntityManager;
 
-using ComponentTuple = std::tuple<
-								TransformComponent,
-								ShapeComponent,
-								CollisionComponent,
-								ScoreComponent,
-								LifespanComponent,
-								InputComponent
-								>;
-
+// Lightweight, copyable view of a pooled entity. Like a pointer, a const Entity
+// still grants mutable access to its components. Holds no ownership; once the
+// entity is removed the handle goes stale and isActive() reports false.
 class Entity
 {
 	friend class EntityManager;
 
 	public:
-		bool				isActive() const { return (active_); }
-		void				destroy() { active_ = false; }
-		size_t				id() const { return (id_); }
-		const std::string&	tag() const { return (tag_); }
+		bool				isActive() const { return (pool_->isActive(handle_)); }
+		bool				isValid() const { return (pool_->isValid(handle_)); }
+		void				destroy() const { pool_->destroy(handle_); }
+		size_t				id() const { return (pool_->id(handle_)); }
+		EntityTag			tag() const { return (pool_->tag(handle_)); }
+		EntityHandle		handle() const { return (handle_); }
 
 		template<typename T>
 		bool				hasComponent() const { return (getComponent<T>().exists_); }
 
 		template<typename T, typename... TArgs>
-		T&					addComponent(TArgs&&... mArgs)
+		T&					addComponent(TArgs&&... mArgs) const
 		{
 			auto& component = getComponent<T>();
 			component = T(std::forward<TArgs>(mArgs)...);
@@ -41,19 +36,18 @@ class Entity
 		}
 
 		template<typename T>
-		T&					getComponent() { return (std::get<T>(components_)); }
-
-		template<typename T>
-		const T&			getComponent() const { return (std::get<T>(components_)); }
+		T&					getComponent() const
+		{
+			assert(isValid() && "stale entity handle");
+			return (pool_->get<T>(handle_));
+		}
 
 	private:
-		Entity(const size_t& id, const std::string& tag) :
-			id_{id}, tag_{tag} {}
+		Entity(EntityPool& pool, const EntityHandle handle) :
+			pool_{&pool}, handle_{handle} {}
 
-		ComponentTuple	components_;
-		bool			active_ = true;
-		std::string		tag_ = "default";
-		size_t			id_ = 0;
+		EntityPool*		pool_ = nullptr;
+		EntityHandle	handle_;
 };
 
 #endif
\ No newline at end of file
@@ -2,34 +2,142 @@
 # define ENTITY_MANAGER_H
 
 # include <vector>
-# include <map>
-# include <memory>
+# include <array>
 # include <algorithm>
 
 # include "Entity.h"
+# include "CommandBuffer.h"
+# include "JobSystem.h"
+# include "Snapshot.h"
 
-using EntityVec = std::vector<std::shared_ptr<Entity>>;
-using EntityMap = std::map<std::string, EntityVec>;
+using EntityVec = std::vector<Entity>;
+using EntityMap = std::array<EntityVec, entityTagCount>;
+using SignatureMap = std::array<EntityVec, signatureCount>;
 
+template<typename... Ts>
+class EntityView;
+
+// New entities and every recorded command become visible at the next update(),
+// the single point where structural changes are applied.
+// Dead entities are removed by swapping the last entity of the list into their
+// place, so update() costs O(added + destroyed) rather than O(alive). Lists are
+// therefore not in creation order, but the order only depends on which entities
+// were added and destroyed, never on which thread destroyed them, so runs stay
+// deterministic.
+// Entities are also bucketed by signature, the set of components they hold when
+// they are added, so view<Ts...>() can skip every bucket that lacks one of Ts.
+// Components added later through CommandBuffer::addComponent move the entity to
+// its new bucket; Entity::addComponent is only meant for entities that have not
+// been added yet.
 class EntityManager
 {
 	public:
-		EntityManager();;
+		EntityManager();
 
 		void	update();
+		// Whether update() has anything to apply.
+		bool	hasPendingChanges() const;
 
-		std::shared_ptr<Entity>	addEntity(const std::string& tag);
+		Entity					addEntity(const EntityTag tag);
+		// One command buffer per job system thread, so systems can record changes without locking.
+		void					setThreadCount(const size_t count) { buffers_.resize(std::max<size_t>(1, count)); }
+		CommandBuffer&			commands() { return (buffers_[JobSystem::currentThreadIndex()]); }
+		Entity					getEntity(const EntityHandle handle);
 		const EntityVec&		getEntities() const;
-		const EntityVec&		getEntities(const std::string& tag);
+		const EntityVec&		getEntities(const EntityTag tag) const;
 		const EntityMap&		getEntityMap() const;
+		const SignatureMap&		getSignatureMap() const;
+		// Entities holding at least the components Ts, as of the last update().
+		template<typename... Ts>
+		EntityView<Ts...>		view() const;
+		const EntityPool&		getPool() const;
+
+		// Only valid right after update(), when nothing is pending. load() returns false on a malformed snapshot.
+		void					save(SnapshotWriter& out) const;
+		bool					load(SnapshotReader& in);
+
+		template<typename T>
+		ComponentArray<T>&		getComponentArray() { return (pool_.array<T>()); }
 
 	private:
-		void		removeDeadEntities(EntityVec& vec);
+		void		applyCommands();
+		void		removeEntity(const uint32_t index);
+		bool		isListed(const EntityHandle handle) const;
+		void		updateSignature(const Entity& entity);
+		void		swapRemove(EntityVec& vec, const uint32_t position, uint32_t EntityPool::Slot::* field);
+		static void	saveSlot(SnapshotWriter& out, const EntityPool::Slot& slot);
+		// False when a field is out of range.
+		static bool	loadSlot(SnapshotReader& in, EntityPool::Slot& slot);
+
+		struct CommandRef
+		{
+			uint64_t	order_;
+			uint32_t	buffer_;
+			uint32_t	index_;
+		};
+
+		EntityPool				pool_;
+		EntityVec				entities_;
+		EntityVec				entitiesToAdd_;
+		EntityMap				entityMap_;
+		SignatureMap			signatureMap_;
+		std::vector<uint32_t>	killed_;
+		std::vector<CommandBuffer>	buffers_ = std::vector<CommandBuffer>(1);
+		std::vector<CommandRef>	commandOrder_;
+		size_t					totalEntities_ = 0;
+};
+
+// Iterates the signature buckets that contain every component of Ts, so no
+// entity outside the view is visited. Positions run through the buckets in
+// signature order, which makes [begin, end) ranges usable with parallelFor.
+// Only valid until the next EntityManager::update().
+template<typename... Ts>
+class EntityView
+{
+	public:
+		static constexpr uint32_t	signature = componentBits<Ts...>();
+
+		explicit EntityView(const EntityManager& entities)
+		{
+			const auto& buckets = entities.getSignatureMap();
+			for (size_t bits = 0; bits < signatureCount; ++bits)
+			{
+				if ((bits & signature) != signature || buckets[bits].empty()) { continue ; }
+
+				buckets_[bucketCount_++] = &buckets[bits];
+				size_ += buckets[bits].size();
+			}
+		}
+
+		size_t	size() const { return (size_); }
+		bool	empty() const { return (size_ == 0); }
 
-		EntityVec	entities_;
-		EntityVec	entitiesToAdd_;
-		EntityMap	entityMap_;
-		size_t		totalEntities_ = 0;
+		// Calls fn(entity, components...) for every entity in the view.
+		template<typename F>
+		void	each(F&& fn) const { each(0, size_, fn); }
+
+		// Same, for the entities at positions [begin, end).
+		template<typename F>
+		void	each(const size_t begin, const size_t end, F&& fn) const
+		{
+			size_t offset = 0;
+			for (size_t bucket = 0; bucket < bucketCount_ && offset < end; ++bucket)
+			{
+				const EntityVec& entities = *buckets_[bucket];
+				const size_t first = std::max(begin, offset) - offset;
+				const size_t last = std::min(end - offset, entities.size());
+				for (size_t i = first; i < last; ++i) { fn(entities[i], entities[i].getComponent<Ts>()...); }
+				offset += entities.size();
+			}
+		}
+
+	private:
+		std::array<const EntityVec*, signatureCount>	buckets_{};
+		size_t											bucketCount_ = 0;
+		size_t											size_ = 0;
 };
 
+template<typename... Ts>
+EntityView<Ts...>	EntityManager::view() const { return (EntityView<Ts...>{*this}); }
+
 #endif
\ No newline at end of file
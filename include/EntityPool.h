@@ -0,0 +1,116 @@
+#ifndef ENTITY_POOL_H
+# define ENTITY_POOL_H
+
+# include <atomic>
+# include <cstdint>
+# include <tuple>
+# include <type_traits>
+# include <vector>
+
+# include "Components.h"
+# include "EntityTag.h"
+# include "ComponentStorage.h"
+
+using ComponentTuple = std::tuple<
+								TransformComponent,
+								ShapeComponent,
+								CollisionComponent,
+								ScoreComponent,
+								LifespanComponent,
+								InputComponent
+								>;
+
+using ComponentPool = ComponentStorage<ComponentTuple>;
+
+template<typename T, typename Tuple>
+struct TupleIndex;
+
+template<typename T, typename... Ts>
+struct TupleIndex<T, std::tuple<T, Ts...>> : std::integral_constant<size_t, 0> {};
+
+template<typename T, typename U, typename... Ts>
+struct TupleIndex<T, std::tuple<U, Ts...>> : std::integral_constant<size_t, 1 + TupleIndex<T, std::tuple<Ts...>>::value> {};
+
+// One bit per component type, in ComponentTuple order.
+template<typename... Ts>
+constexpr uint32_t	componentBits() { return ((0u | ... | (1u << TupleIndex<Ts, ComponentTuple>::value))); }
+
+// The set of components an entity has, as componentBits; one value per possible combination.
+constexpr size_t	signatureCount = size_t{1} << std::tuple_size_v<ComponentTuple>;
+
+// 64-bit reference to a pool slot. The generation is bumped every time the slot
+// is released, so a handle kept past its entity's death is detected as stale.
+struct EntityHandle
+{
+	uint32_t	index_ = UINT32_MAX;
+	uint32_t	generation_ = 0;
+
+	bool	operator == (const EntityHandle& rhs) const { return (index_ == rhs.index_ && generation_ == rhs.generation_); }
+	bool	operator != (const EntityHandle& rhs) const { return (!(*this == rhs)); }
+};
+
+class EntityManager;
+
+// destroy() clears the slot's active flag and appends it to a kill list that
+// EntityManager::update() drains. Two threads may destroy different entities at
+// the same time: the list is pre-sized to the slot count and filled through an
+// atomic cursor, and an active slot is only ever destroyed once.
+class EntityPool
+{
+	friend class EntityManager;
+
+	public:
+		EntityHandle		create(const EntityTag tag, const size_t id);
+		void				release(const EntityHandle handle);
+
+		bool				isValid(const EntityHandle handle) const
+		{
+			return (handle.index_ < slots_.size() && slots_[handle.index_].generation_ == handle.generation_);
+		}
+		bool				isActive(const EntityHandle handle) const { return (isValid(handle) && slots_[handle.index_].active_); }
+		void				destroy(const EntityHandle handle)
+		{
+			if (!isActive(handle)) { return ; }
+
+			slots_[handle.index_].active_ = false;
+			killList_[killCount_.fetch_add(1, std::memory_order_relaxed)] = handle.index_;
+		}
+		size_t				id(const EntityHandle handle) const { return (slots_[handle.index_].id_); }
+		EntityTag			tag(const EntityHandle handle) const { return (slots_[handle.index_].tag_); }
+
+		template<typename T>
+		T&					get(const EntityHandle handle) { return (components_.get<T>(handle.index_)); }
+
+		template<typename T>
+		ComponentArray<T>&	array() { return (components_.array<T>()); }
+
+		size_t				size() const { return (slots_.size() - freeSlots_.size()); }
+		size_t				capacity() const { return (slots_.size()); }
+		size_t				bytes() const
+		{
+			return (slots_.capacity() * sizeof(Slot) + (freeSlots_.capacity() + killList_.capacity()) * sizeof(uint32_t)
+					+ components_.bytes());
+		}
+
+	private:
+		struct Slot
+		{
+			uint32_t	generation_ = 0;
+			bool		active_ = false;
+			EntityTag	tag_ = EntityTag::Default;
+			size_t		id_ = 0;
+			// Positions in EntityManager's global list, tag bucket and signature bucket, kept up to date as entities are swapped around.
+			uint32_t	listIndex_ = 0;
+			uint32_t	bucketIndex_ = 0;
+			uint32_t	signatureIndex_ = 0;
+			uint32_t	signature_ = 0;
+		};
+
+		std::vector<Slot>		slots_;
+		std::vector<uint32_t>	freeSlots_;
+		std::vector<uint32_t>	killList_;
+		std::atomic<size_t>		killCount_{0};
+		ComponentPool			components_;
+};
+
+#endif
\ No newline at end of file
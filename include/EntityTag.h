@@ -0,0 +1,44 @@
+#ifndef ENTITY_TAG_H
+# define ENTITY_TAG_H
+
+# include <array>
+# include <cstddef>
+# include <cstdint>
+# include <string>
+
+// Every tag the game uses is registered here once. Entities store the compact
+// ID, so tag checks in systems are a single integer compare and the manager can
+// keep one bucket per tag in a flat array.
+enum class EntityTag : uint8_t
+{
+	Default,
+	Player,
+	Enemy,
+	SmallEnemy,
+	Bullet,
+	Count
+};
+
+constexpr size_t	entityTagCount = static_cast<size_t>(EntityTag::Count);
+
+constexpr std::array<const char*, entityTagCount>	entityTagNames = {
+	"default",
+	"player",
+	"enemy",
+	"smallEnemy",
+	"bullet"
+};
+
+inline const char*	tagName(const EntityTag tag) { return (entityTagNames[static_cast<size_t>(tag)]); }
+
+inline EntityTag	tagFromName(const std::string& name)
+{
+	for (size_t i = 0; i < entityTagCount; ++i)
+	{
+		if (name == entityTagNames[i]) { return (static_cast<EntityTag>(i)); }
+	}
+
+	return (EntityTag::Default);
+}
+
+#endif
\ No newline at end of file
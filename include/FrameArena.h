@@ -0,0 +1,74 @@
+#ifndef FRAME_ARENA_H
+# define FRAME_ARENA_H
+
+# include <algorithm>
+# include <atomic>
+# include <cstddef>
+# include <memory>
+# include <mutex>
+# include <vector>
+
+// Linear allocator for data that only lives for one simulation tick, such as
+// query results. Allocating bumps an offset through one block (lock-free, so
+// systems running side by side can share it); reset() rewinds it and nothing is
+// freed individually. A tick that outgrows the block spills into overflow blocks,
+// which the next reset() folds into one larger block, so after a warm-up tick
+// the arena no longer touches the heap.
+class FrameArena
+{
+	public:
+		explicit FrameArena(const size_t capacity = 0);
+
+		FrameArena(const FrameArena&) = delete;
+		FrameArena&	operator = (const FrameArena&) = delete;
+
+		// alignment must not exceed alignof(std::max_align_t).
+		void*	allocate(const size_t bytes, const size_t alignment);
+		// Invalidates everything allocated since the last reset.
+		void	reset();
+
+		size_t	capacity() const { return (capacity_); }
+		size_t	used() const { return (std::min(offset_.load(std::memory_order_relaxed), capacity_) + overflowBytes_); }
+		size_t	peak() const { return (peak_); }
+
+	private:
+		std::unique_ptr<std::max_align_t[]>				block_;
+		size_t											capacity_ = 0;
+		std::atomic<size_t>								offset_{0};
+		std::mutex										overflowMutex_;
+		std::vector<std::unique_ptr<std::max_align_t[]>>	overflow_;
+		size_t											overflowBytes_ = 0;
+		size_t											peak_ = 0;
+};
+
+// Standard allocator drawing from a FrameArena; deallocate is a no-op.
+template<typename T>
+class ArenaAllocator
+{
+	public:
+		using value_type = T;
+
+		explicit ArenaAllocator(FrameArena& arena) :
+			arena_{&arena} {}
+		template<typename U>
+		ArenaAllocator(const ArenaAllocator<U>& other) :
+			arena_{other.arena()} {}
+
+		T*			allocate(const size_t count) { return (static_cast<T*>(arena_->allocate(count * sizeof(T), alignof(T)))); }
+		void		deallocate(T*, const size_t) {}
+
+		FrameArena*	arena() const { return (arena_); }
+
+		template<typename U>
+		bool		operator == (const ArenaAllocator<U>& other) const { return (arena_ == other.arena()); }
+		template<typename U>
+		bool		operator != (const ArenaAllocator<U>& other) const { return (arena_ != other.arena()); }
+
+	private:
+		FrameArena*	arena_;
+};
+
+template<typename T>
+using ArenaVector = std::vector<T, ArenaAllocator<T>>;
+
+#endif
@@ -7,55 +7,153 @@
 # include "EntityManager.h"
 # include "Entity.h"
 # include "GameConfig.h"
+# include "CommandLine.h"
+# include "SpatialGrid.h"
+# include "MotionKernels.h"
+# include "ShapeRenderer.h"
+# include "JobSystem.h"
+# include "SystemSchedule.h"
+# include "RandomGenerator.h"
+# include "InputRecording.h"
+# include "Profiler.h"
+# include "RunReport.h"
+# include "ResourceCache.h"
+# include "StartupTimer.h"
+# include "Hud.h"
+# include "Snapshot.h"
+# include "ParticleSystem.h"
+# include "InputThread.h"
+# include "RenderSnapshot.h"
+# include "TripleBuffer.h"
+# include "FrameArena.h"
+
+# include <atomic>
+# include <memory>
+# include <mutex>
+# include <thread>
 
 class Game
 {
 	public:
-		Game(const std::string& configPath);
+		Game(const LaunchOptions& options);
 
-		void	run();
+		int		run();
 
 	private:
-		void					init(const std::string& configPath);
-		void					initText(sf::Text& text, sf::Font& font, const Font& fontConfig, const std::string& str);
+		void					init(const LaunchOptions& options);
+		void					initWindow(StartupTimer& startup);
 
 		void					spawnPlayer();
 		void					spawnEnemy();
-		void					spawnSmallEnemies(std::shared_ptr<Entity> entity);
+		void					spawnSmallEnemies(const Entity& entity);
 		void					spawnBullet(const Vec2f& startPos, const Vec2f& targetPos);
 		void					specialWeapon(const Vec2f& startPos);
+		void					spawnScenario();
+		void					spawnGroup(const EntityTag tag, const SpawnGroupConfig& group);
+		void					fireVolley(const VolleyConfig& volley);
+
+		void					buildSchedule();
+		int						runHeadless();
+		void					step();
+
+		void					captureDueSnapshot();
+		void					captureSnapshot();
+		void					saveState(std::vector<char>& data) const;
+		bool					loadState(const std::vector<char>& data);
+		void					rewind(const size_t age);
+		void					saveStateFile(const std::string& path);
+		bool					loadStateFile(const std::string& path);
+		// Rewinding or loading would desync a recording or a replay from its input stream.
+		bool					canRestore() const { return (!recorder_ && !replay_); }
 
 		void					inputSystem();
+		void					drainInput();
+		void					applyInput(const InputFrame& input);
 		void					enemySpawnerSystem();
 		void					movementSystem();
 		void					collisionSystem();
 		void					lifespanSystem();
-		void					GUISystem();
-		void					renderSystem();
+		void					particleSystem();
+		void					publishRender(const RenderSnapshot::Clock::time_point now, const double accumulator);
+		void					applyGuiChanges();
+
+		// Render side: only reads RenderSnapshot and the members below marked as render state.
+		void					renderLoop();
+		void					renderFrame();
+		void					GUISystem(const GuiStats& stats);
+		void					profilerTab(const GuiStats& stats);
+		void					snapshotTab(const GuiStats& stats);
+		void					memoryTab(const GuiStats& stats);
+		void					renderSystem(const RenderSnapshot& frame, const float alpha);
+
+		void					packMotion(ArenaVector<Entity>& motionEntities, const Entity& entity);
+		const std::vector<uint32_t>&	collisionCandidates(const Vec2f& pos, const float radius, const bool useGrid,
+															std::vector<uint32_t>& scratch) const;
 
 		sf::RenderWindow		window_;
+		std::unique_ptr<InputThread>	inputThread_;
+		LatencyStats			inputToSimLatency_;
 		GameConfig				gameConfig_;
 		ImGuiConfig				imGuiConfig_;
-		sf::Clock				deltaClock_;
 		EntityManager			entities_;
-
-		sf::Font				scoreFont_;
-		sf::Text				scoreText_;
-
-		sf::Font				highScoreFont_;
-		sf::Text				highScoreText_;
-
-		sf::Font				specialWeaponFont_;
-		sf::Text				specialWeaponText_;
-
-		sf::Font				pauseFont_;
-		sf::Text				pauseText_;
+		RandomGenerator			random_;
+		InputFrame				pendingInput_;
+		std::unique_ptr<InputRecorder>	recorder_;
+		std::unique_ptr<InputReplay>	replay_;
+		std::unique_ptr<JobSystem>	jobs_;
+		SystemSchedule			schedule_;
+		// Scratch for one tick's query results; reset at the start of step().
+		FrameArena				frameArena_{512 * 1024};
+		MotionBuffer			motionBuffer_;
+		SpatialGrid				collisionGrid_;
+		ParticleSystem			particles_;
+		std::vector<uint32_t>	collisionTargets_;
+		std::vector<uint32_t>	collisionCandidates_;
+		std::vector<std::vector<uint32_t>>	collisionScratch_;
+
+		ResourceCache			resources_;
+
+		struct PendingInput
+		{
+			uint64_t					sequence_ = 0;
+			InputEvent::Clock::time_point	time_;
+		};
+
+		// Simulation to render thread.
+		TripleBuffer<RenderSnapshot>	renderBuffer_;
+		uint64_t				renderSequence_ = 0;
+		SpscQueue<sf::Event>	windowEvents_{256};
+		SpscQueue<PendingInput>	inputsToPresent_{1024};
+		std::atomic<bool>		guiWantsMouse_{false};
+		std::thread				renderThread_;
+		std::atomic<bool>		renderStopping_{false};
+
+		// Render thread to simulation, taken by applyGuiChanges().
+		std::mutex				guiMutex_;
+		GuiSettings				guiMailboxSettings_;
+		GuiCommands				guiMailboxCommands_;
+		bool					guiMailboxFresh_ = false;
+
+		// Render state.
+		GuiSettings				guiSettings_;
+		GuiCommands				guiCommands_;
+		sf::Clock				deltaClock_;
+		ShapeRenderer			shapeRenderer_;
+		Hud						hud_;
+		std::vector<float>		profilerSamples_;
+		int						rewindAge_ = 0;
+		LatencyStats			inputToPresentLatency_;
+		std::vector<PendingInput>	waitingInputs_;
+
+		SnapshotRing			snapshots_;
+		std::vector<char>		stateFile_;
+		float					snapshotMicros_ = 0.0f;
+		double					snapshotTotalMicros_ = 0.0;
+		size_t					snapshotCount_ = 0;
+		uint64_t				tickAllocations_ = 0;
 
 		size_t					score_ = 0;
 		size_t					highScore_ = 0;
-		std::string				specialWeaponAvailable_ = "Special Weapon Ready!";
-		std::string				specialWeaponCooldown_ = "Cooldown in Progress...";
-		std::string				pause_ = "PAUSED";
 
 		int						currentFrame_ = 0;
 		int						lastEnemySpawnTime_ = 0;
@@ -63,8 +161,11 @@ class Game
 		bool					isSpecialWeaponAvailable_ = true;
 		bool					paused_ = false;
 		bool					running_ = true;
+		bool					headless_ = false;
+		// Where a headless run writes its JSON report, if anywhere.
+		std::optional<std::string>	reportPath_;
 
-		std::shared_ptr<Entity>	player();
+		Entity					player();
 };
 
 #endif
\ No newline at end of file
@@ -2,9 +2,12 @@
 # define GAME_CONFIG_H
 
 # include <SFML/Graphics.hpp>
+# include <array>
 # include <cstdint>
+# include <vector>
 
 # include "Vec2.h"
+# include "AllocationCounter.h"
 
 struct Color
 {
@@ -72,6 +75,20 @@ struct BulletConfig
 	int		lifespan_ = 75;
 };
 
+// Visual only: none of these change a run, so they are left out of the gameplay hash.
+struct ParticleConfig
+{
+	size_t	capacity_ = 20000;
+	size_t	sparks_ = 12;
+	float	sparkSpeed_ = 6.0f;
+	int		sparkLifespan_ = 30;
+	// Ticks between bullet trail particles; 0 turns trails off.
+	int		trailInterval_ = 2;
+	int		trailLifespan_ = 12;
+	// Streak length in ticks of travel.
+	float	streak_ = 2.0f;
+};
+
 struct WindowConfig
 {
 	int			width_ = 1440;
@@ -81,6 +98,79 @@ struct WindowConfig
 	int			frameLimit_ = 60;
 };
 
+struct CollisionConfig
+{
+	bool	spatialGrid_ = true;
+	float	cellSize_ = 64.0f;
+};
+
+struct SimulationConfig
+{
+	bool	headless_ = false;
+	int		frames_ = 3600;
+	int		tickRate_ = 60;
+	int		maxTicksPerFrame_ = 5;
+	int		workers_ = 0;
+	uint64_t	seed_ = 0;
+	// Rewind history length; 0 turns the snapshot ring off.
+	int		snapshotSeconds_ = 5;
+	// Ticks between ring snapshots.
+	int		snapshotInterval_ = 1;
+	// Headless runs cannot rewind, so they skip the ring unless asked to measure its cost.
+	bool	headlessSnapshots_ = false;
+	// Sample keyboard and mouse on a separate thread instead of once per frame.
+	bool	inputThread_ = true;
+	int		inputPollHz_ = 1000;
+	// Draw on a separate thread from the newest published frame instead of after each frame's ticks.
+	bool	renderThread_ = true;
+};
+
+enum class SpawnDistribution
+{
+	Uniform,
+	Cluster
+};
+
+// Entities of one tag placed in the world before the first tick.
+// lifespan_ < 0 keeps the tag's usual lifespan, 0 makes them live forever.
+struct SpawnGroupConfig
+{
+	size_t				count_ = 0;
+	SpawnDistribution	distribution_ = SpawnDistribution::Uniform;
+	Vec2f				center_ = { 0.5f, 0.5f };
+	float				spread_ = 0.1f;
+	Range<float>		speedRange_ = { 1.0f, 5.0f };
+	Range<size_t>		verticeRange_ = { 3, 8 };
+	int					lifespan_ = -1;
+};
+
+// Fired from the player at frame_, then every interval_ frames, repeat_ times in total.
+struct VolleyConfig
+{
+	int		frame_ = 0;
+	int		interval_ = 0;
+	int		repeat_ = 1;
+	size_t	bullets_ = 0;
+	size_t	enemies_ = 0;
+};
+
+struct ScenarioConfig
+{
+	std::string					name_ = "default";
+	SpawnGroupConfig			enemies_;
+	SpawnGroupConfig			smallEnemies_;
+	SpawnGroupConfig			bullets_;
+	std::vector<VolleyConfig>	volleys_;
+	bool						spawning_ = true;
+	int							frames_ = 0;
+	float						frameBudgetMs_ = 0.0f;
+	// From this frame on no tick may allocate from the heap; -1 turns the check off.
+	int							steadyStateFrame_ = -1;
+	// Peak live bytes allowed per memory tag and in total; 0 is unlimited.
+	std::array<size_t, memoryTagCount>	memoryBudgets_{};
+	size_t						memoryBudgetTotal_ = 0;
+};
+
 struct UIConfig
 {
 	Font	score_ = {
@@ -115,16 +205,22 @@ struct ImGuiConfig
 	bool	lifespan_ = true;
 	bool	collision_ = true;
 	bool	spawning_ = true;
+	bool	particles_ = true;
 	bool	rendering_ = true;
 };
 
 struct GameConfig
 {
-	PlayerConfig	playerConfig_;
-	EnemyConfig		enemyConfig_;
-	BulletConfig	bulletConfig_;
-	WindowConfig	windowConfig_;
-	UIConfig		uiConfig_;
+	PlayerConfig		playerConfig_;
+	EnemyConfig			enemyConfig_;
+	BulletConfig		bulletConfig_;
+	ParticleConfig		particleConfig_;
+	WindowConfig		windowConfig_;
+	UIConfig			uiConfig_;
+	CollisionConfig		collisionConfig_;
+	SimulationConfig	simulationConfig_;
+	ScenarioConfig		scenarioConfig_;
+	uint64_t			hash_ = 0;
 };
 
 #endif
\ No newline at end of file
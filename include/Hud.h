@@ -0,0 +1,55 @@
+#ifndef HUD_H
+# define HUD_H
+
+# include <SFML/Graphics.hpp>
+# include <string>
+
+# include "GameConfig.h"
+# include "ResourceCache.h"
+
+// Score, high score, special weapon and pause texts. A text's glyph geometry is
+// only rebuilt when the value it shows changes, and the static "SCORE:" and
+// "HIGH SCORE:" labels are rendered once into a texture drawn as one sprite.
+class Hud
+{
+	public:
+		void	requestFonts(ResourceCache& resources, const UIConfig& uiConfig);
+		void	init(const ResourceCache& resources, const GameConfig& gameConfig);
+
+		void	setScore(const size_t score) { setValue(score_, score); }
+		void	setHighScore(const size_t highScore) { setValue(highScore_, highScore); }
+		void	setSpecialWeaponReady(const bool ready) { specialWeaponReady_ = ready; }
+
+		void	draw(sf::RenderTarget& target, const bool paused) const;
+
+	private:
+		struct Counter
+		{
+			sf::Text	label_;
+			sf::Text	value_;
+			size_t		shown_ = 0;
+			bool		valid_ = false;
+		};
+
+		void	initText(sf::Text& text, const sf::Font& font, const Font& fontConfig, const std::string& str) const;
+		void	initCounter(Counter& counter, const sf::Font& font, const Font& fontConfig, const std::string& label) const;
+		void	setValue(Counter& counter, const size_t value);
+
+		Vec2f				windowSize_;
+		FontHandle			scoreFont_ = 0;
+		FontHandle			highScoreFont_ = 0;
+		FontHandle			specialWeaponFont_ = 0;
+		FontHandle			pauseFont_ = 0;
+
+		Counter				score_;
+		Counter				highScore_;
+		sf::RenderTexture	labels_;
+		sf::Sprite			labelSprite_;
+
+		sf::Text			specialWeaponReadyText_;
+		sf::Text			specialWeaponCooldownText_;
+		sf::Text			pauseText_;
+		bool				specialWeaponReady_ = true;
+};
+
+#endif
@@ -0,0 +1,101 @@
+#ifndef INPUT_RECORDING_H
+# define INPUT_RECORDING_H
+
+# include <cstdint>
+# include <fstream>
+# include <string>
+# include <vector>
+
+# include "Vec2.h"
+
+struct InputAction
+{
+	enum Type : uint8_t
+	{
+		Shoot,
+		SpecialWeapon,
+		TogglePause
+	};
+
+	Type	type_ = Shoot;
+	Vec2i	target_;
+};
+
+// Player input consumed by one simulation tick: held movement keys plus the
+// discrete actions (clicks, pause toggles) that happened since the last tick.
+struct InputFrame
+{
+	bool						up_ = false;
+	bool						down_ = false;
+	bool						left_ = false;
+	bool						right_ = false;
+	std::vector<InputAction>	actions_;
+
+	uint8_t	buttons() const;
+	void	setButtons(const uint8_t buttons);
+};
+
+struct RecordingHeader
+{
+	uint64_t	seed_ = 0;
+	uint64_t	configHash_ = 0;
+	uint32_t	tickRate_ = 60;
+};
+
+// Binary layout (little endian):
+//   "GWIR" u32 version, u64 seed, u64 configHash, u32 tickRate
+//   records: u16 runLength, u8 buttons, u16 actionCount, actionCount * (u8 type, i32 x, i32 y)
+// A record covers runLength consecutive ticks holding the same buttons; its
+// actions belong to the first of those ticks.
+class InputRecorder
+{
+	public:
+		InputRecorder(const std::string& path, const RecordingHeader& header);
+		~InputRecorder();
+
+		InputRecorder(const InputRecorder&) = delete;
+		InputRecorder&	operator = (const InputRecorder&) = delete;
+
+		void		write(const InputFrame& frame);
+		void		close();
+
+		uint32_t	ticks() const { return (ticks_); }
+
+	private:
+		void		flushRecord();
+
+		std::ofstream	out_;
+		std::string		path_;
+		InputFrame		current_;
+		uint16_t		runLength_ = 0;
+		uint32_t		ticks_ = 0;
+};
+
+class InputReplay
+{
+	public:
+		explicit InputReplay(const std::string& path);
+
+		// Overwrites frame with the input for the next tick; an empty frame once the
+		// recording is exhausted. Reuses the frame's action storage.
+		void					next(InputFrame& frame);
+
+		bool					finished() const { return (cursor_ >= records_.size()); }
+		uint32_t				ticks() const { return (ticks_); }
+		const RecordingHeader&	header() const { return (header_); }
+
+	private:
+		struct Record
+		{
+			InputFrame	frame_;
+			uint16_t	runLength_;
+		};
+
+		RecordingHeader		header_;
+		std::vector<Record>	records_;
+		size_t				cursor_ = 0;
+		uint16_t			consumed_ = 0;
+		uint32_t			ticks_ = 0;
+};
+
+#endif
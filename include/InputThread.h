@@ -0,0 +1,78 @@
+#ifndef INPUT_THREAD_H
+# define INPUT_THREAD_H
+
+# include <SFML/Window.hpp>
+# include <atomic>
+# include <chrono>
+# include <thread>
+# include <vector>
+
+# include "InputRecording.h"
+# include "Profiler.h"
+# include "SpscQueue.h"
+
+struct InputEvent
+{
+	using Clock = std::chrono::steady_clock;
+
+	enum Type : uint8_t
+	{
+		Buttons,
+		Action
+	};
+
+	Type				type_ = Buttons;
+	uint8_t				buttons_ = 0;
+	InputAction			action_;
+	Clock::time_point	time_;
+};
+
+// Samples keyboard and mouse state at pollHz on its own thread and pushes every
+// change, stamped with the time it was seen, into a queue the simulation drains
+// right before each tick. Window events must stay on the thread that created the
+// window, so this uses SFML's real-time state queries instead of pollEvent.
+class InputThread
+{
+	public:
+		InputThread(const sf::Window& window, const int pollHz);
+		~InputThread();
+
+		InputThread(const InputThread&) = delete;
+		InputThread&	operator = (const InputThread&) = delete;
+
+		// Keys are ignored while the window is not focused.
+		void	setFocused(const bool focused) { focused_.store(focused, std::memory_order_relaxed); }
+		bool	poll(InputEvent& event) { return (queue_.pop(event)); }
+
+		size_t	dropped() const { return (dropped_.load(std::memory_order_relaxed)); }
+
+	private:
+		void	run();
+		void	push(const InputEvent& event);
+
+		const sf::Window&			window_;
+		const std::chrono::nanoseconds	interval_;
+		SpscQueue<InputEvent>		queue_;
+		std::atomic<bool>			focused_{true};
+		std::atomic<bool>			stopping_{false};
+		std::atomic<size_t>			dropped_{0};
+		std::thread					thread_;
+};
+
+// Rolling window of latency samples in milliseconds.
+class LatencyStats
+{
+	public:
+		static constexpr size_t	historySize = 256;
+
+		void			add(const InputEvent::Clock::time_point from, const InputEvent::Clock::time_point to);
+		ProfileStats	stats() const;
+		size_t			size() const { return (count_); }
+
+	private:
+		float		samples_[historySize] = {};
+		size_t		next_ = 0;
+		size_t		count_ = 0;
+};
+
+#endif
@@ -0,0 +1,98 @@
+#ifndef JOB_SYSTEM_H
+# define JOB_SYSTEM_H
+
+# include <atomic>
+# include <condition_variable>
+# include <cstddef>
+# include <functional>
+# include <memory>
+# include <mutex>
+# include <thread>
+# include <type_traits>
+# include <vector>
+
+# include "AllocationCounter.h"
+
+// Non-owning reference to a callable taking a [begin, end) range. parallelFor
+// waits for every chunk, so the callable outlives its jobs and never has to be
+// copied to the heap the way std::function does with larger captures.
+class RangeFn
+{
+	public:
+		template<typename F, typename = std::enable_if_t<!std::is_same_v<std::decay_t<F>, RangeFn>>>
+		RangeFn(F&& body) :
+			body_{const_cast<void*>(static_cast<const void*>(std::addressof(body)))},
+			call_{[](void* body, const size_t begin, const size_t end) { (*static_cast<std::remove_reference_t<F>*>(body))(begin, end); }} {}
+
+		void	operator () (const size_t begin, const size_t end) const { call_(body_, begin, end); }
+
+	private:
+		void*	body_;
+		void	(*call_)(void* body, const size_t begin, const size_t end);
+};
+
+// Work-stealing thread pool. Every thread (the caller included) owns a deque:
+// it pushes and pops its own jobs at the back while idle threads steal from the
+// front of the others. A thread waiting on its own jobs keeps executing queued
+// work, so parallelFor may be nested inside another job.
+class JobSystem
+{
+	public:
+		// threadCount includes the calling thread; 0 picks the hardware thread count, 1 runs everything inline.
+		explicit JobSystem(const size_t threadCount = 1);
+		~JobSystem();
+
+		JobSystem(const JobSystem&) = delete;
+		JobSystem&	operator = (const JobSystem&) = delete;
+
+		// Calls body on [0, count) split into chunks of grain, chunk k covering [k * grain, (k + 1) * grain).
+		// Chunk boundaries do not depend on the thread count.
+		void			parallelFor(const size_t count, const size_t grain, const RangeFn& body);
+		void			parallelInvoke(const std::vector<std::function<void()>>& tasks);
+
+		size_t			threadCount() const { return (queues_.size()); }
+		static size_t	chunkCount(const size_t count, const size_t grain) { return ((count + grain - 1) / grain); }
+
+		// 0 on the thread that created the pool, 1..threadCount-1 on workers.
+		static size_t	currentThreadIndex();
+
+	private:
+		struct Job
+		{
+			const RangeFn*		body_ = nullptr;
+			size_t				begin_ = 0;
+			size_t				end_ = 0;
+			std::atomic<size_t>*	pending_ = nullptr;
+			// Allocations made by the job are charged to the tag of the thread that queued it.
+			MemoryTag			tag_ = MemoryTag::Other;
+		};
+
+		// Ring of jobs that only grows, so pushing and popping never allocates once
+		// it has held the largest batch.
+		struct WorkQueue
+		{
+			std::mutex			mutex_;
+			std::vector<Job>	jobs_;
+			size_t				head_ = 0;
+			size_t				size_ = 0;
+
+			void	pushBack(const Job& job);
+			Job		popBack();
+			Job		popFront();
+		};
+
+		void	workerLoop(const size_t index);
+		bool	tryRunOne(const size_t index);
+		bool	popLocal(const size_t index, Job& job);
+		bool	steal(const size_t index, Job& job);
+		void	execute(const Job& job);
+
+		std::vector<std::unique_ptr<WorkQueue>>	queues_;
+		std::vector<std::thread>				workers_;
+		std::mutex								sleepMutex_;
+		std::condition_variable					wake_;
+		std::atomic<size_t>						queued_{0};
+		std::atomic<bool>						stopping_{false};
+};
+
+#endif
\ No newline at end of file
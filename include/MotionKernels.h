@@ -0,0 +1,93 @@
+#ifndef MOTION_KERNELS_H
+# define MOTION_KERNELS_H
+
+# include <cstddef>
+# include <vector>
+
+// Packed structure-of-arrays view over a batch of moving bodies.
+struct MotionBatch
+{
+	float*			posX_ = nullptr;
+	float*			posY_ = nullptr;
+	float*			velX_ = nullptr;
+	float*			velY_ = nullptr;
+	const float*	radius_ = nullptr;
+	size_t			count_ = 0;
+};
+
+// Owns the packed arrays a MotionBatch points into. Buffers keep their capacity
+// between frames, so refilling them does not allocate in steady state.
+struct MotionBuffer
+{
+	std::vector<float>	posX_;
+	std::vector<float>	posY_;
+	std::vector<float>	velX_;
+	std::vector<float>	velY_;
+	std::vector<float>	radius_;
+
+	void		clear()
+	{
+		posX_.clear();
+		posY_.clear();
+		velX_.clear();
+		velY_.clear();
+		radius_.clear();
+	}
+
+	void		push(const float posX, const float posY, const float velX, const float velY, const float radius)
+	{
+		posX_.push_back(posX);
+		posY_.push_back(posY);
+		velX_.push_back(velX);
+		velY_.push_back(velY);
+		radius_.push_back(radius);
+	}
+
+	size_t		size() const { return (posX_.size()); }
+
+	MotionBatch	batch(const size_t first, const size_t count)
+	{
+		return (MotionBatch{posX_.data() + first, posY_.data() + first, velX_.data() + first,
+							velY_.data() + first, radius_.data() + first, count});
+	}
+};
+
+// Position integration and wall bouncing over whole batches. The widest
+// instruction set the CPU supports is picked once at startup; every variant
+// produces bit-identical results.
+class MotionKernels
+{
+	public:
+		enum class Isa
+		{
+			Scalar,
+			SSE2,
+			AVX2
+		};
+
+		// pos += vel
+		static void			integrate(const MotionBatch& batch);
+		// pos += vel, then flip the velocity sign on each axis where the circle leaves [0, width] x [0, height].
+		static void			integrateAndBounce(const MotionBatch& batch, const float width, const float height);
+
+		static Isa			detectIsa();
+		static Isa			activeIsa();
+		static bool			setIsa(const Isa isa);
+		static const char*	isaName(const Isa isa);
+
+	private:
+		using IntegrateFn = void (*)(const MotionBatch&);
+		using BounceFn = void (*)(const MotionBatch&, const float, const float);
+
+		struct Dispatch
+		{
+			Isa			isa_;
+			IntegrateFn	integrate_;
+			BounceFn	integrateAndBounce_;
+		};
+
+		static Dispatch&	dispatch();
+		static Dispatch		makeDispatch(const Isa isa);
+};
+
+#endif
\ No newline at end of file
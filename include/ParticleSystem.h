@@ -0,0 +1,58 @@
+#ifndef PARTICLE_SYSTEM_H
+# define PARTICLE_SYSTEM_H
+
+# include <SFML/Graphics.hpp>
+# include <cstdint>
+# include <vector>
+
+# include "RandomGenerator.h"
+# include "Vec2.h"
+
+// Purely visual sparks and trails kept out of EntityManager. Particles live in a
+// fixed-capacity struct-of-arrays pool (emits beyond capacity are dropped), die by
+// compacting the arrays in place and are drawn as fading streaks in the shape batch.
+// They never touch gameplay state, so they are skipped in headless runs and are
+// not part of snapshots.
+class ParticleSystem
+{
+	public:
+		struct Instance
+		{
+			Vec2f		pos_;
+			Vec2f		velocity_;
+			sf::Color	color_;
+		};
+
+		ParticleSystem();
+
+		void	reset(const size_t capacity);
+		void	clear() { count_ = 0; }
+
+		void	emit(const Vec2f& pos, const Vec2f& velocity, const sf::Color color, const int lifespan);
+		// count particles flying outwards from pos at speed, each with a small random spread.
+		void	burst(const Vec2f& pos, const size_t count, const float speed, const sf::Color color, const int lifespan);
+
+		void	update();
+		// Live particles with their fade applied, for the render snapshot.
+		void	collect(std::vector<Instance>& out) const;
+
+		size_t	size() const { return (count_); }
+		size_t	capacity() const { return (posX_.size()); }
+		size_t	dropped() const { return (dropped_); }
+
+	private:
+		std::vector<float>		posX_;
+		std::vector<float>		posY_;
+		std::vector<float>		velX_;
+		std::vector<float>		velY_;
+		std::vector<int>		remaining_;
+		std::vector<int>		lifespan_;
+		std::vector<sf::Color>	color_;
+		size_t					count_ = 0;
+		size_t					dropped_ = 0;
+
+		// Separate from the gameplay RandomGenerator so effects cannot change a run.
+		RandomStream			random_;
+};
+
+#endif
@@ -0,0 +1,143 @@
+#ifndef PROFILER_H
+# define PROFILER_H
+
+# include <array>
+# include <chrono>
+# include <cstddef>
+# include <cstdint>
+# include <mutex>
+# include <string>
+# include <vector>
+
+// Per-system frame profiler. PROFILE_SCOPE times the enclosing block when the
+// build enables GEOMETRY_WARS_PROFILER and expands to nothing otherwise.
+enum class ProfileZone : uint8_t
+{
+	Input,
+	EntityUpdate,
+	Spawner,
+	Movement,
+	Lifespan,
+	Collision,
+	GUI,
+	Particles,
+	Publish,
+	Render,
+	Snapshot,
+	Count
+};
+
+constexpr size_t	profileZoneCount = static_cast<size_t>(ProfileZone::Count);
+
+constexpr std::array<const char*, profileZoneCount>	profileZoneNames = {
+	"input",
+	"entityUpdate",
+	"spawner",
+	"movement",
+	"lifespan",
+	"collision",
+	"gui",
+	"particles",
+	"publish",
+	"render",
+	"snapshot"
+};
+
+struct ProfileStats
+{
+	float	p50_ = 0.0f;
+	float	p99_ = 0.0f;
+	float	max_ = 0.0f;
+};
+
+class Profiler
+{
+	public:
+		using Clock = std::chrono::steady_clock;
+
+		static constexpr size_t	historySize = 600;
+
+# ifdef GEOMETRY_WARS_PROFILER
+		static constexpr bool	enabled = true;
+# else
+		static constexpr bool	enabled = false;
+# endif
+
+		static void			beginFrame();
+		static void			endFrame();
+		static void			record(const ProfileZone zone, const Clock::time_point start, const Clock::time_point end);
+		// Labels the calling thread's row in the Chrome trace.
+		static void			setThreadName(const std::string& name);
+
+		// Milliseconds per frame, oldest first. zone == ProfileZone::Count selects the whole frame.
+		static void			history(const ProfileZone zone, std::vector<float>& result);
+		static ProfileStats	stats(const ProfileZone zone);
+		// Reorders samples.
+		static ProfileStats	stats(std::vector<float>& samples);
+
+		static void			writeChromeTrace(const std::string& path);
+		static void			logSummary();
+
+	private:
+		struct Span
+		{
+			Clock::time_point	start_;
+			Clock::time_point	end_;
+			uint32_t			thread_;
+		};
+
+		struct Frame
+		{
+			Clock::time_point									start_;
+			Clock::time_point									end_;
+			uint32_t											thread_ = 0;
+			std::array<float, profileZoneCount>					ms_{};
+			std::array<std::vector<Span>, profileZoneCount>		spans_;
+		};
+
+		// Guarded by mutex_: systems record from workers and the render thread while the main thread ends frames.
+		struct State
+		{
+			std::mutex			mutex_;
+			Clock::time_point	epoch_ = Clock::now();
+			std::vector<Frame>	frames_ = std::vector<Frame>(historySize);
+			Frame				current_;
+			size_t				next_ = 0;
+			size_t				count_ = 0;
+			// Indexed by profiler thread id; empty for threads that never named themselves.
+			std::vector<std::string>	threadNames_;
+		};
+
+		static State&		state();
+		// Needs mutex_ held. Ids are handed out on a thread's first use, so every
+		// thread gets its own row whether or not it belongs to the JobSystem.
+		static uint32_t		threadId(State& s);
+		static float		frameMs(const Frame& frame, const ProfileZone zone);
+};
+
+class ProfileScope
+{
+	public:
+		explicit ProfileScope(const ProfileZone zone) :
+			zone_{zone}, start_{Profiler::Clock::now()} {}
+
+		~ProfileScope()
+		{
+			Profiler::record(zone_, start_, Profiler::Clock::now());
+		}
+
+		ProfileScope(const ProfileScope&) = delete;
+		ProfileScope&	operator = (const ProfileScope&) = delete;
+
+	private:
+		ProfileZone					zone_;
+		Profiler::Clock::time_point	start_;
+};
+
+# ifdef GEOMETRY_WARS_PROFILER
+#  define PROFILE_SCOPE(zone) ProfileScope profileScope{zone}
+# else
+#  define PROFILE_SCOPE(zone) static_cast<void>(0)
+# endif
+
+#endif
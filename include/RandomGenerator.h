@@ -1,84 +1,118 @@
 #ifndef RANDOM_GENERATOR_H
 # define RANDOM_GENERATOR_H
 
-# include <random>
+# include <SFML/Graphics/Color.hpp>
+
+# include <cmath>
+# include <cstdint>
+# include <cstddef>
 
 # include "Vec2.h"
 # include "GameConfig.h"
 
-class RandomGenerator
+// PCG32 (XSH-RR). Each stream id selects an independent sequence for the same seed.
+class RandomStream
 {
 	public:
-		static Vec2f	getRandomEnemyPos(const GameConfig& gameConfig, const Vec2f playerPos)
-		{
-			auto& gen = getGenerator();
-
-			float enemyRadius = static_cast<float>(gameConfig.enemyConfig_.shapeRadius_);
+		RandomStream() = default;
 
-			std::uniform_real_distribution<float> posX(enemyRadius + 1.0f, gameConfig.windowConfig_.width_ - enemyRadius - 1.0f);
-			std::uniform_real_distribution<float> posY(enemyRadius + 1.0f, gameConfig.windowConfig_.height_ - enemyRadius - 1.0f);
-
-			float	playerRadius = static_cast<float>(gameConfig.playerConfig_.shapeRadius_);
-			float	x;
-			float	y;
-			while (true)
-			{
-				x = posX(gen);
-				y = posY(gen);
+		RandomStream(const uint64_t seed, const uint64_t streamId) :
+			state_{0u}, inc_{(streamId << 1u) | 1u}
+		{
+			next();
+			state_ += seed;
+			next();
+		}
 
-				if (std::abs(playerPos.x_ - x) > playerRadius * 2.0f + enemyRadius ||
-					std::abs(playerPos.y_ - y) > playerRadius * 2.0f + enemyRadius)
-				{
-					break ;
-				}
-			}
+		uint32_t	next()
+		{
+			const uint64_t oldState = state_;
+			state_ = oldState * 6364136223846793005ULL + inc_;
+			const uint32_t xorShifted = static_cast<uint32_t>(((oldState >> 18u) ^ oldState) >> 27u);
+			const uint32_t rot = static_cast<uint32_t>(oldState >> 59u);
 
-			return (Vec2f{x, y});
+			return ((xorShifted >> rot) | (xorShifted << ((32u - rot) & 31u)));
 		}
 
-		static Vec2f	getRandomEnemySpeed(const GameConfig& gameConfig)
+		// Uniform in [min, max).
+		float		uniform(const float min, const float max)
 		{
-			auto& gen = getGenerator();
+			const float unit = static_cast<float>(next() >> 8) * (1.0f / 16777216.0f);
 
-			float	speedMin = gameConfig.enemyConfig_.speedRange_.min_;
-			float	speedMax = gameConfig.enemyConfig_.speedRange_.max_;
+			return (min + (max - min) * unit);
+		}
 
-			std::uniform_real_distribution<float> speed(speedMin, speedMax);
+		// Normal (Box-Muller); u1 is kept away from 0 so the log stays finite.
+		float		normal(const float mean, const float stddev)
+		{
+			const float u1 = uniform(1.0f / 16777216.0f, 1.0f);
+			const float u2 = uniform(0.0f, 6.2831853f);
 
-			return (Vec2f{speed(gen), speed(gen)});
+			return (mean + stddev * std::sqrt(-2.0f * std::log(u1)) * std::cos(u2));
 		}
 
-		static sf::Color	getRandomEnemyColor()
+		// Uniform in [min, max], unbiased (Lemire's multiply-and-reject).
+		uint32_t	uniformInt(const uint32_t min, const uint32_t max)
 		{
-			auto& gen = getGenerator();
+			const uint32_t range = max - min + 1u;
+			if (range == 0u) { return (next()); }
 
-			std::uniform_int_distribution<int> color(0, 255);
+			uint64_t product = static_cast<uint64_t>(next()) * range;
+			uint32_t low = static_cast<uint32_t>(product);
+			if (low < range)
+			{
+				const uint32_t threshold = (0u - range) % range;
+				while (low < threshold)
+				{
+					product = static_cast<uint64_t>(next()) * range;
+					low = static_cast<uint32_t>(product);
+				}
+			}
 
-			return (sf::Color{static_cast<sf::Uint8>(color(gen)),
-								static_cast<sf::Uint8>(color(gen)),
-								static_cast<sf::Uint8>(color(gen))});
+			return (min + static_cast<uint32_t>(product >> 32));
 		}
 
-		static size_t	getRandomEnemyPointCount(const GameConfig& gameConfig)
-		{
-			auto& gen = getGenerator();
+	private:
+		uint64_t	state_ = 0x853c49e6748fea9bULL;
+		uint64_t	inc_ = 0xda3e39cb94b95bdbULL;
+};
+
+class RandomGenerator
+{
+	public:
+		RandomGenerator() = default;
+		explicit RandomGenerator(const uint64_t seed);
 
-			size_t pointCountMin = gameConfig.enemyConfig_.verticeRange_.min_;
-			size_t pointCountMax = gameConfig.enemyConfig_.verticeRange_.max_;
+		void			seed(const uint64_t seed);
+		uint64_t		seed() const;
 
-			std::uniform_int_distribution<size_t> pointCount(pointCountMin, pointCountMax);
+		Vec2f			getRandomEnemyPos(const GameConfig& gameConfig, const Vec2f playerPos);
+		Vec2f			getRandomEnemySpeed(const GameConfig& gameConfig);
+		sf::Color		getRandomEnemyColor();
+		size_t			getRandomEnemyPointCount(const GameConfig& gameConfig);
 
-			return (pointCount(gen));
-		}
+		Vec2f			getScenarioPos(const SpawnGroupConfig& group, const GameConfig& gameConfig, const float radius);
+		Vec2f			getScenarioVelocity(const SpawnGroupConfig& group);
+		size_t			getScenarioPointCount(const SpawnGroupConfig& group);
+
+		static uint64_t	entropySeed();
 
 	private:
-		static std::mt19937&	getGenerator()
+		enum Stream : uint64_t
 		{
-			static std::random_device rd;
-			static std::mt19937 gen(rd());
-
-			return (gen);
-		}
+			Position = 1,
+			Speed,
+			Color,
+			Vertices,
+			Scenario
+		};
+
+		uint64_t		seed_ = 0;
+		RandomStream	position_;
+		RandomStream	speed_;
+		RandomStream	color_;
+		RandomStream	vertices_;
+		RandomStream	scenario_;
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,90 @@
+#ifndef RENDER_SNAPSHOT_H
+# define RENDER_SNAPSHOT_H
+
+# include <array>
+# include <chrono>
+# include <cstdint>
+# include <vector>
+
+# include "Components.h"
+# include "EntityTag.h"
+# include "GameConfig.h"
+# include "ParticleSystem.h"
+# include "Profiler.h"
+
+struct RenderShape
+{
+	Vec2f			prevPos_;
+	Vec2f			pos_;
+	float			prevAngle_ = 0.0f;
+	float			angle_ = 0.0f;
+	ShapeComponent	shape_;
+};
+
+// Read-only numbers the ImGui window shows about the simulation.
+struct GuiStats
+{
+	size_t								entities_ = 0;
+	std::array<size_t, entityTagCount>	tagCounts_{};
+	size_t								particles_ = 0;
+	size_t								particleCapacity_ = 0;
+	size_t								particlesDropped_ = 0;
+	float								snapshotMicros_ = 0.0f;
+	double								snapshotAverageMicros_ = 0.0;
+	size_t								snapshotBytes_ = 0;
+	size_t								ringSize_ = 0;
+	size_t								ringCapacity_ = 0;
+	size_t								ringBytes_ = 0;
+	bool								canRestore_ = true;
+	bool								inputThread_ = false;
+	ProfileStats						inputToSim_;
+	size_t								inputsDropped_ = 0;
+	// Heap allocations charged to entities and systems during the last tick.
+	uint64_t							tickAllocations_ = 0;
+	size_t								poolBytes_ = 0;
+	size_t								poolSlots_ = 0;
+	std::array<size_t, entityTagCount>	bucketBytes_{};
+	size_t								arenaPeak_ = 0;
+	size_t								arenaCapacity_ = 0;
+};
+
+// Everything one rendered frame needs, copied out of the world after the last tick
+// so the renderer never reads simulation state.
+struct RenderSnapshot
+{
+	using Clock = std::chrono::steady_clock;
+
+	uint64_t							sequence_ = 0;
+	// When the newest tick became current; the renderer interpolates from there.
+	Clock::time_point					tickTime_;
+	double								tickSeconds_ = 1.0 / 60.0;
+
+	std::vector<RenderShape>				shapes_;
+	std::vector<ParticleSystem::Instance>	particles_;
+
+	size_t								score_ = 0;
+	size_t								highScore_ = 0;
+	bool								specialWeaponReady_ = true;
+	bool								paused_ = false;
+
+	GuiStats							stats_;
+};
+
+// ImGui edits handed back to the simulation, applied between frames.
+struct GuiSettings
+{
+	ImGuiConfig	config_;
+	bool		spatialGrid_ = true;
+	int			spawnInterval_ = 60;
+};
+
+struct GuiCommands
+{
+	int		manualSpawns_ = 0;
+	// Snapshots back to rewind to; -1 for none.
+	int		rewindAge_ = -1;
+	bool	saveState_ = false;
+	bool	loadState_ = false;
+};
+
+#endif
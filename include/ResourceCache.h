@@ -0,0 +1,37 @@
+#ifndef RESOURCE_CACHE_H
+# define RESOURCE_CACHE_H
+
+# include <SFML/Graphics/Font.hpp>
+
+# include <cstdint>
+# include <future>
+# include <memory>
+# include <string>
+# include <vector>
+
+using FontHandle = uint32_t;
+
+// Loads every distinct font path once and shares it by handle. Fonts are
+// requested up front, loaded together on a background thread by loadAsync(),
+// and become readable after wait(). A font that fails to load ends the program.
+class ResourceCache
+{
+	public:
+		~ResourceCache();
+
+		FontHandle		requestFont(const std::string& path);
+		void			loadAsync();
+		void			wait();
+
+		const sf::Font&	font(const FontHandle handle) const { return (*fonts_[handle]); }
+		size_t			fontCount() const { return (fonts_.size()); }
+
+	private:
+		bool			loadFonts();
+
+		std::vector<std::string>				fontPaths_;
+		std::vector<std::unique_ptr<sf::Font>>	fonts_;
+		std::future<bool>						pending_;
+};
+
+#endif
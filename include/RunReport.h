@@ -0,0 +1,73 @@
+#ifndef RUN_REPORT_H
+# define RUN_REPORT_H
+
+# include <array>
+# include <cstddef>
+# include <cstdint>
+# include <string>
+# include <vector>
+
+# include "AllocationCounter.h"
+# include "GameConfig.h"
+
+struct RunSummary
+{
+	size_t	frames_ = 0;
+	float	meanMs_ = 0.0f;
+	float	p50Ms_ = 0.0f;
+	float	p99Ms_ = 0.0f;
+	float	maxMs_ = 0.0f;
+	size_t	overBudget_ = 0;
+	size_t	peakEntities_ = 0;
+	size_t	peakPoolBytes_ = 0;
+	size_t	peakResidentBytes_ = 0;
+	// Heap allocations made while the measured ticks ran, on any thread.
+	uint64_t	allocations_ = 0;
+	uint64_t	maxFrameAllocations_ = 0;
+	// Frames at or after the steady-state frame that allocated.
+	size_t	allocatingFrames_ = 0;
+	// Per memory tag and in total since startup; only reported with GEOMETRY_WARS_TRACK_MEMORY.
+	std::array<MemoryStats, memoryTagCount>	memory_{};
+	MemoryStats	memoryTotal_;
+};
+
+// Frame times, heap allocations and memory high-water marks of one headless run.
+// A run stays within budget while its p99 frame time does, no frame from the
+// scenario's steadyStateFrame on allocates and no memory tag's peak exceeds its
+// budget. Unset budgets always pass; memory budgets are only checked when the
+// build tracks live bytes.
+class RunReport
+{
+	public:
+		explicit RunReport(const ScenarioConfig& scenario) :
+			scenario_{scenario} {}
+
+		void		reserve(const size_t frames) { frameMs_.reserve(frames); }
+		void		addFrame(const float ms, const size_t entities, const size_t poolBytes, const uint64_t allocations);
+
+		RunSummary	summarize() const;
+		bool		withinFrameBudget(const RunSummary& summary) const;
+		bool		withinMemoryBudget(const RunSummary& summary) const;
+		bool		withinBudget(const RunSummary& summary) const
+		{
+			return (withinFrameBudget(summary) && summary.allocatingFrames_ == 0 && withinMemoryBudget(summary));
+		}
+		void		log(const RunSummary& summary) const;
+		// Writes the summary as JSON; returns false if the file cannot be written.
+		bool		write(const std::string& path, const RunSummary& summary) const;
+
+		static size_t	peakResidentBytes();
+
+	private:
+		void		logMemory(const RunSummary& summary) const;
+
+		const ScenarioConfig&	scenario_;
+		std::vector<float>	frameMs_;
+		size_t				peakEntities_ = 0;
+		size_t				peakPoolBytes_ = 0;
+		uint64_t			allocations_ = 0;
+		uint64_t			maxFrameAllocations_ = 0;
+		size_t				allocatingFrames_ = 0;
+};
+
+#endif
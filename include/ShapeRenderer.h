@@ -0,0 +1,33 @@
+#ifndef SHAPE_RENDERER_H
+# define SHAPE_RENDERER_H
+
+# include <SFML/Graphics.hpp>
+# include <vector>
+
+# include "Components.h"
+# include "Vec2.h"
+
+// Tessellates every shape of a frame into one triangle list and submits it with
+// a single draw call. Each shape's fill is followed by its outline, so overlap
+// order matches drawing the shapes one by one.
+class ShapeRenderer
+{
+	public:
+		ShapeRenderer();
+
+		void	clear();
+		void	add(const Vec2f& pos, const float angle, const ShapeComponent& shape);
+		// A width-wide quad from head to tail, fading out towards the tail.
+		void	addStreak(const Vec2f& head, const Vec2f& tail, const sf::Color color, const float width);
+		void	draw(sf::RenderTarget& target) const;
+
+		size_t	vertexCount() const { return (vertices_.getVertexCount()); }
+
+	private:
+		const std::vector<sf::Vector2f>&	unitPolygon(const size_t pointCount);
+
+		std::vector<std::vector<sf::Vector2f>>	unitPolygons_;
+		sf::VertexArray							vertices_;
+};
+
+#endif
\ No newline at end of file
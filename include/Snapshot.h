@@ -0,0 +1,102 @@
+#ifndef SNAPSHOT_H
+# define SNAPSHOT_H
+
+# include <algorithm>
+# include <cstddef>
+# include <cstring>
+# include <string>
+# include <type_traits>
+# include <vector>
+
+// Snapshots copy plain values with memcpy in native byte order, so a save-state
+// only loads on the architecture and build it was written by.
+// The buffer is grown geometrically while writing and trimmed to the written
+// size when the writer goes out of scope, so a reused buffer stops allocating.
+class SnapshotWriter
+{
+	public:
+		explicit SnapshotWriter(std::vector<char>& data) :
+			data_{data} { data_.resize(data_.capacity()); }
+		~SnapshotWriter() { data_.resize(size_); }
+
+		SnapshotWriter(const SnapshotWriter&) = delete;
+		SnapshotWriter&	operator = (const SnapshotWriter&) = delete;
+
+		template<typename T>
+		void	write(const T& value)
+		{
+			static_assert(std::is_trivially_copyable_v<T>, "snapshots only hold trivially copyable values");
+			writeBytes(&value, sizeof(T));
+		}
+
+		void	writeBytes(const void* bytes, const size_t size)
+		{
+			if (size_ + size > data_.size()) { data_.resize(std::max(data_.size() * 2, size_ + size)); }
+			std::memcpy(data_.data() + size_, bytes, size);
+			size_ += size;
+		}
+
+	private:
+		std::vector<char>&	data_;
+		size_t				size_ = 0;
+};
+
+// Reading past the end leaves the value untouched and marks the reader failed.
+class SnapshotReader
+{
+	public:
+		explicit SnapshotReader(const std::vector<char>& data) :
+			data_{data} {}
+
+		template<typename T>
+		bool	read(T& value)
+		{
+			static_assert(std::is_trivially_copyable_v<T>, "snapshots only hold trivially copyable values");
+			return (readBytes(&value, sizeof(T)));
+		}
+
+		bool	readBytes(void* bytes, const size_t size)
+		{
+			if (failed_ || offset_ + size > data_.size()) { failed_ = true; return (false); }
+
+			std::memcpy(bytes, data_.data() + offset_, size);
+			offset_ += size;
+
+			return (true);
+		}
+
+		bool	failed() const { return (failed_); }
+		size_t	remaining() const { return (data_.size() - offset_); }
+
+	private:
+		const std::vector<char>&	data_;
+		size_t						offset_ = 0;
+		bool						failed_ = false;
+};
+
+// Fixed number of snapshot buffers reused oldest first, so steady-state capture does not allocate.
+class SnapshotRing
+{
+	public:
+		void						reset(const size_t capacity);
+
+		std::vector<char>&			push();
+		// back(0) is the newest snapshot.
+		const std::vector<char>&	back(const size_t age) const { return (slots_[(next_ + slots_.size() - 1 - age) % slots_.size()]); }
+		// Forgets the age newest snapshots, so back(0) becomes what was back(age).
+		void						drop(const size_t age);
+
+		size_t						size() const { return (count_); }
+		size_t						capacity() const { return (slots_.size()); }
+		size_t						bytes() const;
+
+	private:
+		std::vector<std::vector<char>>	slots_;
+		size_t							next_ = 0;
+		size_t							count_ = 0;
+};
+
+bool	writeSnapshotFile(const std::string& path, const std::vector<char>& data);
+bool	readSnapshotFile(const std::string& path, std::vector<char>& data);
+
+#endif
@@ -0,0 +1,48 @@
+#ifndef SPATIAL_GRID_H
+# define SPATIAL_GRID_H
+
+# include <cstdint>
+# include <utility>
+# include <vector>
+
+# include "Vec2.h"
+
+// Uniform grid broadphase rebuilt every frame. Items are inserted into every
+// cell their bounding circle overlaps and packed cell by cell (counting sort),
+// so a query only walks the few cells around the probe.
+// Positions outside the grid are clamped to the border cells.
+class SpatialGrid
+{
+	public:
+		void	reset(const float width, const float height, const float cellSize);
+		void	insert(const uint32_t item, const Vec2f& pos, const float radius);
+		void	build();
+
+		// Fills result with the sorted, de-duplicated items of every cell the circle overlaps.
+		void	query(const Vec2f& pos, const float radius, std::vector<uint32_t>& result) const;
+
+		size_t	cellCount() const { return (static_cast<size_t>(columns_) * rows_); }
+
+	private:
+		struct CellRange
+		{
+			int	minX_;
+			int	minY_;
+			int	maxX_;
+			int	maxY_;
+		};
+
+		CellRange	cellRange(const Vec2f& pos, const float radius) const;
+		int			clampColumn(const float x) const;
+		int			clampRow(const float y) const;
+
+		float									invCellSize_ = 1.0f;
+		int										columns_ = 0;
+		int										rows_ = 0;
+		std::vector<std::pair<uint32_t, uint32_t>>	pending_;
+		std::vector<uint32_t>					cellStart_;
+		std::vector<uint32_t>					cellItems_;
+		std::vector<uint32_t>					cellCursor_;
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,60 @@
+#ifndef SPSC_QUEUE_H
+# define SPSC_QUEUE_H
+
+# include <atomic>
+# include <cstddef>
+# include <vector>
+
+// Bounded lock-free queue for exactly one producer thread and one consumer thread.
+// The capacity is rounded up to a power of two; push fails instead of blocking when full.
+template<typename T>
+class SpscQueue
+{
+	public:
+		explicit SpscQueue(const size_t capacity) :
+			slots_(roundUp(capacity)), mask_{slots_.size() - 1} {}
+
+		SpscQueue(const SpscQueue&) = delete;
+		SpscQueue&	operator = (const SpscQueue&) = delete;
+
+		bool	push(const T& value)
+		{
+			const size_t head = head_.load(std::memory_order_relaxed);
+			if (head - tail_.load(std::memory_order_acquire) == slots_.size()) { return (false); }
+
+			slots_[head & mask_] = value;
+			head_.store(head + 1, std::memory_order_release);
+
+			return (true);
+		}
+
+		bool	pop(T& value)
+		{
+			const size_t tail = tail_.load(std::memory_order_relaxed);
+			if (tail == head_.load(std::memory_order_acquire)) { return (false); }
+
+			value = slots_[tail & mask_];
+			tail_.store(tail + 1, std::memory_order_release);
+
+			return (true);
+		}
+
+		size_t	capacity() const { return (slots_.size()); }
+
+	private:
+		static size_t	roundUp(const size_t capacity)
+		{
+			size_t size = 1;
+			while (size < capacity) { size <<= 1; }
+
+			return (size);
+		}
+
+		std::vector<T>					slots_;
+		const size_t					mask_;
+		// Producer and consumer indices on separate cache lines.
+		alignas(64) std::atomic<size_t>	head_{0};
+		alignas(64) std::atomic<size_t>	tail_{0};
+};
+
+#endif
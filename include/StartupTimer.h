@@ -0,0 +1,43 @@
+#ifndef STARTUP_TIMER_H
+# define STARTUP_TIMER_H
+
+# include <spdlog/spdlog.h>
+
+# include <chrono>
+# include <string>
+# include <utility>
+# include <vector>
+
+// Splits startup into named phases: each mark() closes the phase that began at
+// the previous mark (or at construction), and log() prints them on one line.
+class StartupTimer
+{
+	public:
+		using Clock = std::chrono::steady_clock;
+
+		void	mark(const char* phase)
+		{
+			const auto now = Clock::now();
+			phases_.emplace_back(phase, std::chrono::duration<double, std::milli>(now - last_).count());
+			last_ = now;
+		}
+
+		void	log() const
+		{
+			std::string breakdown;
+			for (const auto& [phase, ms] : phases_)
+			{
+				if (!breakdown.empty()) { breakdown += ", "; }
+				breakdown += fmt::format("{} {:.1f} ms", phase, ms);
+			}
+
+			SPDLOG_INFO("Startup: {:.1f} ms ({})", std::chrono::duration<double, std::milli>(last_ - start_).count(), breakdown);
+		}
+
+	private:
+		Clock::time_point								start_ = Clock::now();
+		Clock::time_point								last_ = start_;
+		std::vector<std::pair<const char*, double>>		phases_;
+};
+
+#endif
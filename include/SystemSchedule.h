@@ -0,0 +1,59 @@
+#ifndef SYSTEM_SCHEDULE_H
+# define SYSTEM_SCHEDULE_H
+
+# include <cstdint>
+# include <functional>
+# include <string>
+# include <tuple>
+# include <vector>
+
+# include "EntityPool.h"
+# include "JobSystem.h"
+
+// Accesses are componentBits, followed by the non-component resources systems can touch.
+constexpr uint32_t	allComponentBits = (1u << std::tuple_size_v<ComponentTuple>) - 1;
+// Entity creation and destruction (pool slots, active flags, pending lists).
+// Spawning may also grow every component array, so spawners write allComponentBits too.
+constexpr uint32_t	lifetimeBit = 1u << std::tuple_size_v<ComponentTuple>;
+// Game members such as score_, highScore_ and the special weapon timers.
+constexpr uint32_t	gameStateBit = lifetimeBit << 1;
+
+struct SystemAccess
+{
+	uint32_t	reads_ = 0;
+	uint32_t	writes_ = 0;
+
+	bool	conflictsWith(const SystemAccess& rhs) const
+	{
+		return ((writes_ & (rhs.reads_ | rhs.writes_)) != 0 || (rhs.writes_ & reads_) != 0);
+	}
+};
+
+// Runs systems in declaration order, fusing consecutive systems whose declared
+// accesses do not conflict into one stage that executes in parallel.
+class SystemSchedule
+{
+	public:
+		void		add(const std::string& name, const SystemAccess& access, std::function<void()> system);
+		void		run(JobSystem& jobs) const;
+		std::string	describe() const;
+
+	private:
+		struct System
+		{
+			std::string				name_;
+			SystemAccess			access_;
+			std::function<void()>	run_;
+		};
+
+		struct Stage
+		{
+			std::vector<size_t>					systems_;
+			std::vector<std::function<void()>>	tasks_;
+		};
+
+		std::vector<System>	systems_;
+		std::vector<Stage>	stages_;
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,40 @@
+#ifndef TRIPLE_BUFFER_H
+# define TRIPLE_BUFFER_H
+
+# include <array>
+# include <atomic>
+# include <cstdint>
+
+// Lock-free hand-off of whole values from one writer thread to one reader thread.
+// The writer fills back() and publish()es it; the reader's acquire() switches to
+// the newest published value, skipping any it never saw. Neither side ever waits,
+// and each keeps its own buffer, so both may reuse the memory inside it.
+template<typename T>
+class TripleBuffer
+{
+	public:
+		T&			back() { return (buffers_[back_]); }
+		void		publish() { back_ = middle_.exchange(static_cast<uint8_t>(back_ | fresh), std::memory_order_acq_rel) & indexMask; }
+
+		// true if front() changed.
+		bool		acquire()
+		{
+			if (!(middle_.load(std::memory_order_relaxed) & fresh)) { return (false); }
+
+			front_ = middle_.exchange(front_, std::memory_order_acq_rel) & indexMask;
+
+			return (true);
+		}
+		const T&	front() const { return (buffers_[front_]); }
+
+	private:
+		static constexpr uint8_t	indexMask = 0x3;
+		static constexpr uint8_t	fresh = 0x4;
+
+		std::array<T, 3>		buffers_{};
+		uint8_t					back_ = 0;
+		std::atomic<uint8_t>	middle_{1};
+		uint8_t					front_ = 2;
+};
+
+#endif
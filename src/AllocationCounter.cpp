@@ -0,0 +1,187 @@
+#include "AllocationCounter.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <utility>
+#ifdef _WIN32
+# include <malloc.h>
+#endif
+
+namespace
+{
+	struct TagCounters
+	{
+		std::atomic<uint64_t>	allocations_{0};
+		std::atomic<size_t>		liveBytes_{0};
+		std::atomic<size_t>		peakBytes_{0};
+	};
+
+	// Constant-initialized, so they are ready for allocations made before main().
+	std::atomic<uint64_t>					allocations{0};
+	std::array<TagCounters, memoryTagCount>	tagCounters;
+	TagCounters								totalCounters;
+	thread_local MemoryTag					threadTag = MemoryTag::Other;
+
+	MemoryStats	load(const TagCounters& counters)
+	{
+		return (MemoryStats{counters.allocations_.load(std::memory_order_relaxed), counters.liveBytes_.load(std::memory_order_relaxed),
+							counters.peakBytes_.load(std::memory_order_relaxed)});
+	}
+}
+
+uint64_t	AllocationCounter::count()
+{
+	return (allocations.load(std::memory_order_relaxed));
+}
+
+MemoryStats	AllocationCounter::stats(const MemoryTag tag)
+{
+	return (load(tagCounters[static_cast<size_t>(tag)]));
+}
+
+MemoryStats	AllocationCounter::total()
+{
+	MemoryStats stats = load(totalCounters);
+	stats.allocations_ = count();
+
+	return (stats);
+}
+
+MemoryTag	AllocationCounter::currentTag()
+{
+	return (threadTag);
+}
+
+MemoryTag	AllocationCounter::exchangeTag(const MemoryTag tag)
+{
+	return (std::exchange(threadTag, tag));
+}
+
+#if defined(GEOMETRY_WARS_COUNT_ALLOCATIONS) || defined(GEOMETRY_WARS_TRACK_MEMORY)
+
+namespace
+{
+	// Tracked blocks start with this header, padded to the block's alignment, so
+	// delete knows how many bytes to give back and to which tag.
+	struct Header
+	{
+		size_t		size_;
+		uint32_t	offset_;
+		MemoryTag	tag_;
+	};
+
+	static_assert(sizeof(Header) <= alignof(std::max_align_t), "header must fit in the default alignment");
+
+	void	raisePeak(std::atomic<size_t>& peak, const size_t value)
+	{
+		size_t current = peak.load(std::memory_order_relaxed);
+		while (current < value && !peak.compare_exchange_weak(current, value, std::memory_order_relaxed)) {}
+	}
+
+	void	charge(TagCounters& counters, const size_t bytes)
+	{
+		raisePeak(counters.peakBytes_, counters.liveBytes_.fetch_add(bytes, std::memory_order_relaxed) + bytes);
+	}
+
+	void*	rawAllocate(const std::size_t size, const std::size_t align)
+	{
+		if (align <= alignof(std::max_align_t)) { return (std::malloc(size == 0 ? 1 : size)); }
+#ifdef _WIN32
+		return (_aligned_malloc(size == 0 ? 1 : size, align));
+#else
+		// aligned_alloc wants the size rounded up to the alignment.
+		return (std::aligned_alloc(align, (std::max<std::size_t>(size, 1) + align - 1) / align * align));
+#endif
+	}
+
+	void	rawFree(void* pointer, const std::size_t align)
+	{
+#ifdef _WIN32
+		if (align > alignof(std::max_align_t)) { _aligned_free(pointer); return ; }
+#endif
+		static_cast<void>(align);
+		std::free(pointer);
+	}
+
+	void*	allocate(const std::size_t size, const std::size_t align) noexcept
+	{
+		const MemoryTag tag = threadTag;
+		auto& counters = tagCounters[static_cast<size_t>(tag)];
+		allocations.fetch_add(1, std::memory_order_relaxed);
+		counters.allocations_.fetch_add(1, std::memory_order_relaxed);
+		if constexpr (!AllocationCounter::tracking) { return (rawAllocate(size, align)); }
+
+		const std::size_t offset = std::max(align, alignof(std::max_align_t));
+		auto* base = static_cast<std::byte*>(rawAllocate(size + offset, align));
+		if (base == nullptr) { return (nullptr); }
+
+		new (base + offset - sizeof(Header)) Header{size, static_cast<uint32_t>(offset), tag};
+		charge(counters, size);
+		charge(totalCounters, size);
+
+		return (base + offset);
+	}
+
+	void	deallocate(void* pointer, const std::size_t align) noexcept
+	{
+		if (pointer == nullptr) { return ; }
+		if constexpr (!AllocationCounter::tracking) { rawFree(pointer, align); return ; }
+
+		auto* block = static_cast<std::byte*>(pointer);
+		const Header header = *reinterpret_cast<const Header*>(block - sizeof(Header));
+		tagCounters[static_cast<size_t>(header.tag_)].liveBytes_.fetch_sub(header.size_, std::memory_order_relaxed);
+		totalCounters.liveBytes_.fetch_sub(header.size_, std::memory_order_relaxed);
+		rawFree(block - header.offset_, align);
+	}
+
+	void*	allocateOrThrow(const std::size_t size, const std::size_t align)
+	{
+		if (void* pointer = allocate(size, align)) { return (pointer); }
+		throw std::bad_alloc{};
+	}
+
+	constexpr std::size_t	defaultAlign = alignof(std::max_align_t);
+}
+
+void*	operator new(std::size_t size) { return (allocateOrThrow(size, defaultAlign)); }
+void*	operator new[](std::size_t size) { return (allocateOrThrow(size, defaultAlign)); }
+void*	operator new(std::size_t size, const std::nothrow_t&) noexcept { return (allocate(size, defaultAlign)); }
+void*	operator new[](std::size_t size, const std::nothrow_t&) noexcept { return (allocate(size, defaultAlign)); }
+void*	operator new(std::size_t size, std::align_val_t alignment) { return (allocateOrThrow(size, static_cast<std::size_t>(alignment))); }
+void*	operator new[](std::size_t size, std::align_val_t alignment) { return (allocateOrThrow(size, static_cast<std::size_t>(alignment))); }
+void*	operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+	return (allocate(size, static_cast<std::size_t>(alignment)));
+}
+void*	operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+	return (allocate(size, static_cast<std::size_t>(alignment)));
+}
+void	operator delete(void* pointer) noexcept { deallocate(pointer, defaultAlign); }
+void	operator delete[](void* pointer) noexcept { deallocate(pointer, defaultAlign); }
+void	operator delete(void* pointer, std::size_t) noexcept { deallocate(pointer, defaultAlign); }
+void	operator delete[](void* pointer, std::size_t) noexcept { deallocate(pointer, defaultAlign); }
+void	operator delete(void* pointer, const std::nothrow_t&) noexcept { deallocate(pointer, defaultAlign); }
+void	operator delete[](void* pointer, const std::nothrow_t&) noexcept { deallocate(pointer, defaultAlign); }
+void	operator delete(void* pointer, std::align_val_t alignment) noexcept { deallocate(pointer, static_cast<std::size_t>(alignment)); }
+void	operator delete[](void* pointer, std::align_val_t alignment) noexcept { deallocate(pointer, static_cast<std::size_t>(alignment)); }
+void	operator delete(void* pointer, std::size_t, std::align_val_t alignment) noexcept
+{
+	deallocate(pointer, static_cast<std::size_t>(alignment));
+}
+void	operator delete[](void* pointer, std::size_t, std::align_val_t alignment) noexcept
+{
+	deallocate(pointer, static_cast<std::size_t>(alignment));
+}
+void	operator delete(void* pointer, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+	deallocate(pointer, static_cast<std::size_t>(alignment));
+}
+void	operator delete[](void* pointer, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+	deallocate(pointer, static_cast<std::size_t>(alignment));
+}
+
+#endif
@@ -0,0 +1,29 @@
+#include "CommandBuffer.h"
+
+CommandBuffer::Spawn	CommandBuffer::spawn(const EntityTag tag)
+{
+	const MemoryScope scope{MemoryTag::Entities};
+	record(Command::Spawn, tag, EntityHandle{}, prototypes_.size());
+	prototypes_.emplace_back();
+
+	return (Spawn{*this, prototypes_.size() - 1});
+}
+
+void	CommandBuffer::destroy(const Entity& entity)
+{
+	const MemoryScope scope{MemoryTag::Entities};
+	record(Command::Destroy, entity.tag(), entity.handle(), 0);
+}
+
+void	CommandBuffer::clear()
+{
+	commands_.clear();
+	prototypes_.clear();
+	components_.clear();
+	order_ = 0;
+}
+
+void	CommandBuffer::record(const Command::Type type, const EntityTag tag, const EntityHandle handle, const size_t payload)
+{
+	commands_.push_back(Command{order_, type, tag, handle, payload});
+}
@@ -0,0 +1,68 @@
+#include "CommandLine.h"
+
+# include <spdlog/spdlog.h>
+
+LaunchOptions	CommandLine::parse(int argc, char** argv)
+{
+	LaunchOptions options;
+
+	for (int i = 1; i < argc; ++i)
+	{
+		const std::string arg{argv[i]};
+		if (arg == "--headless") { options.headless_ = true; }
+		else if (arg == "--frames" && i + 1 < argc) { options.frames_ = parseInt(arg, argv[++i]); }
+		else if (arg == "--workers" && i + 1 < argc) { options.workers_ = parseInt(arg, argv[++i]); }
+		else if (arg == "--seed" && i + 1 < argc) { options.seed_ = parseUnsigned(arg, argv[++i]); }
+		else if (arg == "--record" && i + 1 < argc) { options.recordPath_ = argv[++i]; }
+		else if (arg == "--replay" && i + 1 < argc) { options.replayPath_ = argv[++i]; }
+		else if (arg == "--scenario" && i + 1 < argc) { options.scenarioPath_ = argv[++i]; }
+		else if (arg == "--load-state" && i + 1 < argc) { options.loadStatePath_ = argv[++i]; }
+		else if (arg == "--report" && i + 1 < argc) { options.reportPath_ = argv[++i]; }
+		else if (arg == "--brute-force") { options.spatialGrid_ = false; }
+		else if (arg == "--snapshots") { options.snapshots_ = true; }
+		else if (arg == "--help" || arg == "-h") { printUsage(argv[0]); exit(0); }
+		else if (arg.rfind("--", 0) != 0) { options.configPath_ = arg; }
+		else
+		{
+			SPDLOG_ERROR("Unknown option: {}", arg);
+			printUsage(argv[0]);
+			exit(1);
+		}
+	}
+
+	return (options);
+}
+
+int		CommandLine::parseInt(const std::string& option, const char* value)
+{
+	try
+	{
+		return (std::stoi(value));
+	}
+	catch (const std::exception&)
+	{
+		SPDLOG_ERROR("{} expects an integer, got: {}", option, value);
+		exit(1);
+	}
+}
+
+uint64_t	CommandLine::parseUnsigned(const std::string& option, const char* value)
+{
+	try
+	{
+		if (value[0] == '-') { throw std::invalid_argument{value}; }
+		return (std::stoull(value));
+	}
+	catch (const std::exception&)
+	{
+		SPDLOG_ERROR("{} expects an unsigned integer, got: {}", option, value);
+		exit(1);
+	}
+}
+
+void	CommandLine::printUsage(const char* program)
+{
+	SPDLOG_INFO("Usage: {} [config.json] [--headless] [--frames N] [--brute-force] [--workers N] [--seed N]\n"
+				"    [--record input.gwir | --replay input.gwir] [--scenario scenario.json] [--load-state state.gwss]\n"
+				"    [--report run.json] [--snapshots]", program);
+}
@@ -2,33 +2,59 @@
 
 # include <spdlog/spdlog.h>
 # include <fstream>
+# include <algorithm>
 
-GameConfig	ConfigLoader::loadFromFile(const std::string& configPath)
+json	ConfigLoader::parseFile(const std::string& path, const char* kind)
 {
-	std::ifstream config{configPath};
-	if (!config)
+	std::ifstream file{path};
+	if (!file)
 	{
-		SPDLOG_ERROR("Failed to open config file: {}", configPath);
+		SPDLOG_ERROR("Failed to open {} file: {}", kind, path);
 		exit(1);
 	}
 
-	json data = json::parse(config, nullptr, false);
+	json data = json::parse(file, nullptr, false);
 	if (data.is_discarded())
 	{
-		SPDLOG_ERROR("Failed to parse config file: {}", configPath);
+		SPDLOG_ERROR("Failed to parse {} file: {}", kind, path);
 		exit(1);
 	}
 
+	return (data);
+}
+
+GameConfig	ConfigLoader::loadFromFile(const std::string& configPath)
+{
+	json data = parseFile(configPath, "config");
+
 	GameConfig gameConfig;
 	if (data.contains("window")) { loadWindowConfig(gameConfig.windowConfig_, data["window"]); }
 	if (data.contains("player")) { loadPlayerConfig(gameConfig.playerConfig_, data["player"]); }
 	if (data.contains("enemy")) { loadEnemyConfig(gameConfig.enemyConfig_, data["enemy"]); }
 	if (data.contains("bullet")) { loadBulletConfig(gameConfig.bulletConfig_, data["bullet"]); }
+	if (data.contains("particles")) { loadParticleConfig(gameConfig.particleConfig_, data["particles"]); }
 	if (data.contains("ui")) { loadUIConfig(gameConfig.uiConfig_, data["ui"]); }
+	if (data.contains("collision")) { loadCollisionConfig(gameConfig.collisionConfig_, data["collision"]); }
+	if (data.contains("simulation")) { loadSimulationConfig(gameConfig.simulationConfig_, data["simulation"]); }
+	if (data.contains("scenario")) { loadScenarioConfig(gameConfig.scenarioConfig_, data["scenario"]); }
+	gameConfig.hash_ = hashGameplay(data);
 
 	return (gameConfig);
 }
 
+void	ConfigLoader::applyLaunchOptions(GameConfig& gameConfig, const LaunchOptions& options)
+{
+	if (options.scenarioPath_) { loadScenarioFile(gameConfig, *options.scenarioPath_); }
+	if (gameConfig.scenarioConfig_.frames_ > 0) { gameConfig.simulationConfig_.frames_ = gameConfig.scenarioConfig_.frames_; }
+
+	if (options.headless_) { gameConfig.simulationConfig_.headless_ = *options.headless_; }
+	if (options.frames_) { gameConfig.simulationConfig_.frames_ = *options.frames_; }
+	if (options.workers_) { gameConfig.simulationConfig_.workers_ = std::max(0, *options.workers_); }
+	if (options.seed_) { gameConfig.simulationConfig_.seed_ = *options.seed_; }
+	if (options.spatialGrid_) { gameConfig.collisionConfig_.spatialGrid_ = *options.spatialGrid_; }
+	if (options.snapshots_) { gameConfig.simulationConfig_.headlessSnapshots_ = *options.snapshots_; }
+}
+
 void	ConfigLoader::loadWindowConfig(WindowConfig& windowConfig, const json& window)
 {
 	windowConfig.width_ = window.value("width", 1280);
@@ -129,6 +155,17 @@ void	ConfigLoader::loadBulletConfig(BulletConfig& bulletConfig, const json& bull
 	bulletConfig.lifespan_ = bullet.value("lifespan", 75);
 }
 
+void	ConfigLoader::loadParticleConfig(ParticleConfig& particleConfig, const json& particles)
+{
+	particleConfig.capacity_ = particles.value("capacity", size_t{20000});
+	particleConfig.sparks_ = particles.value("sparks", size_t{12});
+	particleConfig.sparkSpeed_ = particles.value("sparkSpeed", 6.0f);
+	particleConfig.sparkLifespan_ = particles.value("sparkLifespan", 30);
+	particleConfig.trailInterval_ = std::max(0, particles.value("trailInterval", 2));
+	particleConfig.trailLifespan_ = particles.value("trailLifespan", 12);
+	particleConfig.streak_ = particles.value("streak", 2.0f);
+}
+
 void	ConfigLoader::loadUIConfig(UIConfig &uiConfig, const json &ui)
 {
 	std::vector<std::pair<Font&, std::string>> fontConfigs{
@@ -166,3 +203,126 @@ void	ConfigLoader::loadFont(Font& font, const json& fontConfig)
 		if (color.contains("a")) { font.color_.a_ = color["a"]; }
 	}
 }
+
+void	ConfigLoader::loadCollisionConfig(CollisionConfig& collisionConfig, const json& collision)
+{
+	collisionConfig.spatialGrid_ = collision.value("spatialGrid", true);
+	collisionConfig.cellSize_ = collision.value("cellSize", 64.0f);
+	if (!(collisionConfig.cellSize_ > 0.0f))
+	{
+		SPDLOG_ERROR("collision.cellSize must be positive, got {}", collisionConfig.cellSize_);
+		exit(1);
+	}
+}
+
+void	ConfigLoader::loadSimulationConfig(SimulationConfig& simulationConfig, const json& simulation)
+{
+	simulationConfig.headless_ = simulation.value("headless", false);
+	simulationConfig.frames_ = simulation.value("frames", 3600);
+	simulationConfig.tickRate_ = std::max(1, simulation.value("tickRate", 60));
+	simulationConfig.maxTicksPerFrame_ = std::max(1, simulation.value("maxTicksPerFrame", 5));
+	simulationConfig.workers_ = std::max(0, simulation.value("workers", 0));
+	simulationConfig.seed_ = simulation.value("seed", uint64_t{0});
+	simulationConfig.snapshotSeconds_ = std::max(0, simulation.value("snapshotSeconds", 5));
+	simulationConfig.snapshotInterval_ = std::max(1, simulation.value("snapshotInterval", 1));
+	simulationConfig.inputThread_ = simulation.value("inputThread", true);
+	simulationConfig.inputPollHz_ = std::max(1, simulation.value("inputPollHz", 1000));
+	simulationConfig.renderThread_ = simulation.value("renderThread", true);
+}
+
+// A scenario file replaces the config's "scenario" section and is folded into the
+// gameplay hash, so a recording made with it does not match a run without it.
+void	ConfigLoader::loadScenarioFile(GameConfig& gameConfig, const std::string& scenarioPath)
+{
+	const json scenario = parseFile(scenarioPath, "scenario");
+
+	gameConfig.scenarioConfig_ = ScenarioConfig{};
+	loadScenarioConfig(gameConfig.scenarioConfig_, scenario);
+	gameConfig.hash_ ^= hashGameplay(json{{"scenario", scenario}});
+}
+
+void	ConfigLoader::loadScenarioConfig(ScenarioConfig& scenarioConfig, const json& scenario)
+{
+	scenarioConfig.name_ = scenario.value("name", "default");
+	if (scenario.contains("enemies")) { loadSpawnGroup(scenarioConfig.enemies_, scenario["enemies"]); }
+	if (scenario.contains("smallEnemies")) { loadSpawnGroup(scenarioConfig.smallEnemies_, scenario["smallEnemies"]); }
+	if (scenario.contains("bullets")) { loadSpawnGroup(scenarioConfig.bullets_, scenario["bullets"]); }
+	if (scenario.contains("volleys"))
+	{
+		for (const auto& volley : scenario["volleys"])
+		{
+			VolleyConfig volleyConfig;
+			volleyConfig.frame_ = std::max(0, volley.value("frame", 0));
+			volleyConfig.interval_ = std::max(0, volley.value("interval", 0));
+			volleyConfig.repeat_ = std::max(1, volley.value("repeat", 1));
+			volleyConfig.bullets_ = volley.value("bullets", size_t{0});
+			volleyConfig.enemies_ = volley.value("enemies", size_t{0});
+			scenarioConfig.volleys_.push_back(volleyConfig);
+		}
+	}
+	scenarioConfig.spawning_ = scenario.value("spawning", true);
+	scenarioConfig.frames_ = std::max(0, scenario.value("frames", 0));
+	scenarioConfig.frameBudgetMs_ = std::max(0.0f, scenario.value("frameBudgetMs", 0.0f));
+	scenarioConfig.steadyStateFrame_ = std::max(-1, scenario.value("steadyStateFrame", -1));
+	if (scenario.contains("memoryBudgetsKiB"))
+	{
+		for (const auto& [name, kib] : scenario["memoryBudgetsKiB"].items())
+		{
+			const size_t bytes = kib.get<size_t>() * 1024;
+			const auto tag = std::find(memoryTagNames.begin(), memoryTagNames.end(), name);
+			if (name == "total") { scenarioConfig.memoryBudgetTotal_ = bytes; }
+			else if (tag != memoryTagNames.end()) { scenarioConfig.memoryBudgets_[tag - memoryTagNames.begin()] = bytes; }
+			else
+			{
+				SPDLOG_ERROR("Unknown memory budget \"{}\" in scenario {}", name, scenarioConfig.name_);
+				exit(1);
+			}
+		}
+	}
+}
+
+void	ConfigLoader::loadSpawnGroup(SpawnGroupConfig& group, const json& groupConfig)
+{
+	group.count_ = groupConfig.value("count", size_t{0});
+	const std::string distribution = groupConfig.value("position", "uniform");
+	if (distribution == "cluster") { group.distribution_ = SpawnDistribution::Cluster; }
+	else if (distribution == "uniform") { group.distribution_ = SpawnDistribution::Uniform; }
+	else { SPDLOG_WARN("Unknown spawn distribution: {}, using uniform", distribution); }
+	if (groupConfig.contains("center"))
+	{
+		const auto& center = groupConfig["center"];
+		group.center_.x_ = center.value("relativeX", 0.5f);
+		group.center_.y_ = center.value("relativeY", 0.5f);
+	}
+	group.spread_ = std::max(0.0f, groupConfig.value("spread", 0.1f));
+	if (groupConfig.contains("speedRange"))
+	{
+		const auto& speedRange = groupConfig["speedRange"];
+		group.speedRange_.min_ = speedRange.value("min", 1.0f);
+		group.speedRange_.max_ = speedRange.value("max", 5.0f);
+	}
+	if (groupConfig.contains("verticesRange"))
+	{
+		const auto& verticesRange = groupConfig["verticesRange"];
+		group.verticeRange_.min_ = std::max(size_t{3}, verticesRange.value("min", size_t{3}));
+		group.verticeRange_.max_ = std::max(group.verticeRange_.min_, verticesRange.value("max", size_t{8}));
+	}
+	group.lifespan_ = groupConfig.value("lifespan", -1);
+}
+
+// FNV-1a over everything except the run settings and visual effects, so a recording
+// made in a window still matches when it is replayed headless or with another worker count.
+uint64_t	ConfigLoader::hashGameplay(json data)
+{
+	data.erase("simulation");
+	data.erase("particles");
+
+	uint64_t hash = 14695981039346656037ULL;
+	for (const char c : data.dump())
+	{
+		hash ^= static_cast<uint8_t>(c);
+		hash *= 1099511628211ULL;
+	}
+
+	return (hash);
+}
@@ -1,47 +1,437 @@
 #include "EntityManager.h"
 
+#include <cassert>
+#include <tuple>
+#include <utility>
+#include <variant>
+
+namespace
+{
+	template<typename T>
+	void	copyComponent(const Entity& entity, const T& component)
+	{
+		if (component.exists_) { entity.getComponent<T>() = component; }
+	}
+
+	// The componentBits of the components the entity has.
+	template<size_t... Is>
+	uint32_t	signatureOf(const Entity& entity, std::index_sequence<Is...>)
+	{
+		return ((0u | ... | (entity.hasComponent<std::tuple_element_t<Is, ComponentTuple>>() ? (1u << Is) : 0u)));
+	}
+
+	// Components are written field by field in fixed-size types for the same
+	// reason slots are; exists_ is implied by the signature and not written.
+	void	writeFlag(SnapshotWriter& out, const bool flag) { out.write(static_cast<uint8_t>(flag)); }
+	void	writeVec(SnapshotWriter& out, const Vec2f& v) { out.write(v.x_); out.write(v.y_); }
+	void	writeColor(SnapshotWriter& out, const sf::Color& color) { out.write(color.r); out.write(color.g); out.write(color.b); out.write(color.a); }
+
+	bool	readFlag(SnapshotReader& in, bool& flag)
+	{
+		uint8_t value = 0;
+		if (!in.read(value) || value > 1) { return (false); }
+		flag = value;
+
+		return (true);
+	}
+	bool	readVec(SnapshotReader& in, Vec2f& v) { return (in.read(v.x_) && in.read(v.y_)); }
+	bool	readColor(SnapshotReader& in, sf::Color& color) { return (in.read(color.r) && in.read(color.g) && in.read(color.b) && in.read(color.a)); }
+
+	void	writeComponent(SnapshotWriter& out, const TransformComponent& c)
+	{
+		writeVec(out, c.pos_);
+		writeVec(out, c.velocity_);
+		out.write(c.angle_);
+		writeVec(out, c.prevPos_);
+		out.write(c.prevAngle_);
+	}
+	void	writeComponent(SnapshotWriter& out, const ShapeComponent& c)
+	{
+		out.write(c.radius_);
+		out.write(static_cast<uint64_t>(c.pointCount_));
+		writeColor(out, c.fillColor_);
+		writeColor(out, c.outlineColor_);
+		out.write(c.outlineThickness_);
+	}
+	void	writeComponent(SnapshotWriter& out, const CollisionComponent& c) { out.write(c.radius_); }
+	void	writeComponent(SnapshotWriter& out, const ScoreComponent& c) { out.write(static_cast<uint64_t>(c.score_)); }
+	void	writeComponent(SnapshotWriter& out, const LifespanComponent& c)
+	{
+		out.write(static_cast<int32_t>(c.lifespan_));
+		out.write(static_cast<int32_t>(c.remaining_));
+	}
+	void	writeComponent(SnapshotWriter& out, const InputComponent& c)
+	{
+		writeFlag(out, c.up_);
+		writeFlag(out, c.down_);
+		writeFlag(out, c.left_);
+		writeFlag(out, c.right_);
+		writeFlag(out, c.shoot_);
+	}
+
+	bool	readComponent(SnapshotReader& in, TransformComponent& c)
+	{
+		return (readVec(in, c.pos_) && readVec(in, c.velocity_) && in.read(c.angle_)
+			&& readVec(in, c.prevPos_) && in.read(c.prevAngle_));
+	}
+	bool	readComponent(SnapshotReader& in, ShapeComponent& c)
+	{
+		uint64_t pointCount = 0;
+		if (!in.read(c.radius_) || !in.read(pointCount)) { return (false); }
+		c.pointCount_ = static_cast<size_t>(pointCount);
+
+		return (readColor(in, c.fillColor_) && readColor(in, c.outlineColor_) && in.read(c.outlineThickness_));
+	}
+	bool	readComponent(SnapshotReader& in, CollisionComponent& c) { return (in.read(c.radius_)); }
+	bool	readComponent(SnapshotReader& in, ScoreComponent& c)
+	{
+		uint64_t score = 0;
+		if (!in.read(score)) { return (false); }
+		c.score_ = static_cast<size_t>(score);
+
+		return (true);
+	}
+	bool	readComponent(SnapshotReader& in, LifespanComponent& c)
+	{
+		int32_t lifespan = 0;
+		int32_t remaining = 0;
+		if (!in.read(lifespan) || !in.read(remaining)) { return (false); }
+		c.lifespan_ = lifespan;
+		c.remaining_ = remaining;
+
+		return (true);
+	}
+	bool	readComponent(SnapshotReader& in, InputComponent& c)
+	{
+		return (readFlag(in, c.up_) && readFlag(in, c.down_) && readFlag(in, c.left_)
+			&& readFlag(in, c.right_) && readFlag(in, c.shoot_));
+	}
+
+	// Marks the component present only when all of its fields were read.
+	template<typename T>
+	void	loadComponent(SnapshotReader& in, T& component)
+	{
+		component.exists_ = readComponent(in, component);
+	}
+
+	// The entity's signature, followed by the components it has.
+	template<size_t... Is>
+	void	saveComponents(SnapshotWriter& out, const Entity& entity, std::index_sequence<Is...> indices)
+	{
+		out.write(static_cast<uint8_t>(signatureOf(entity, indices)));
+		((entity.hasComponent<std::tuple_element_t<Is, ComponentTuple>>()
+			? writeComponent(out, entity.getComponent<std::tuple_element_t<Is, ComponentTuple>>()) : void()), ...);
+	}
+
+	// Reads what saveComponents wrote into components. Returns the signature, or
+	// signatureCount when the data runs out or does not match the signature.
+	template<size_t... Is>
+	uint32_t	readComponents(SnapshotReader& in, ComponentTuple& components, std::index_sequence<Is...>)
+	{
+		uint8_t mask = 0;
+		in.read(mask);
+		components = ComponentTuple{};
+		((mask & (1u << Is) ? loadComponent(in, std::get<Is>(components)) : void()), ...);
+		const uint32_t signature = (0u | ... | (std::get<Is>(components).exists_ ? (1u << Is) : 0u));
+
+		return (in.failed() || signature != mask ? static_cast<uint32_t>(signatureCount) : signature);
+	}
+
+	constexpr auto	componentIndices = std::make_index_sequence<std::tuple_size_v<ComponentTuple>>{};
+
+	// Slots are written field by field in fixed-size types, so the bytes hold no
+	// padding and do not depend on the layout the compiler gives EntityPool::Slot.
+	constexpr size_t	slotBytes = 4 + 1 + 1 + 8 + 4 * 4;
+}
+
 EntityManager::EntityManager() = default;
 
 void	EntityManager::update()
 {
+	const MemoryScope scope{MemoryTag::Entities};
+	applyCommands();
+
 	for (const auto& entity : entitiesToAdd_)
 	{
+		auto& slot = pool_.slots_[entity.handle().index_];
+		auto& bucket = entityMap_[static_cast<size_t>(slot.tag_)];
+		slot.signature_ = signatureOf(entity, componentIndices);
+		auto& signatureBucket = signatureMap_[slot.signature_];
+		slot.listIndex_ = static_cast<uint32_t>(entities_.size());
+		slot.bucketIndex_ = static_cast<uint32_t>(bucket.size());
+		slot.signatureIndex_ = static_cast<uint32_t>(signatureBucket.size());
 		entities_.push_back(entity);
+		bucket.push_back(entity);
+		signatureBucket.push_back(entity);
 	}
 	entitiesToAdd_.clear();
 
-	removeDeadEntities(entities_);
+	// Threads append to the kill list in any order; sorting by slot keeps the swaps deterministic.
+	const size_t killCount = pool_.killCount_.exchange(0, std::memory_order_relaxed);
+	killed_.assign(pool_.killList_.begin(), pool_.killList_.begin() + killCount);
+	std::sort(killed_.begin(), killed_.end());
+	for (const auto index : killed_) { removeEntity(index); }
+}
 
-	for (auto& [tag, entityVec] : entityMap_)
-	{
-		removeDeadEntities(entityVec);
-	}
+bool	EntityManager::hasPendingChanges() const
+{
+	if (!entitiesToAdd_.empty() || pool_.killCount_.load(std::memory_order_relaxed) > 0) { return (true); }
+
+	return (std::any_of(buffers_.begin(), buffers_.end(), [](const CommandBuffer& buffer) { return (!buffer.empty()); }));
 }
 
-std::shared_ptr<Entity>	EntityManager::addEntity(const std::string& tag)
+Entity	EntityManager::addEntity(const EntityTag tag)
 {
-	auto entity = std::shared_ptr<Entity>(new Entity{totalEntities_++, tag});
+	const MemoryScope scope{MemoryTag::Entities};
+	Entity entity{pool_, pool_.create(tag, totalEntities_++)};
 	entitiesToAdd_.push_back(entity);
 
-	auto [iter, success] = entityMap_.try_emplace(tag, EntityVec{});
-	(iter->second).push_back(entity);
-
 	return (entity);
 }
 
+Entity	EntityManager::getEntity(const EntityHandle handle) { return (Entity{pool_, handle}); }
+
 const EntityVec&	EntityManager::getEntities() const { return (entities_); }
 
-const EntityVec&	EntityManager::getEntities(const std::string& tag) { return (entityMap_[tag]); }
+const EntityVec&	EntityManager::getEntities(const EntityTag tag) const { return (entityMap_[static_cast<size_t>(tag)]); }
 
 const EntityMap&	EntityManager::getEntityMap() const { return (entityMap_); }
 
+const SignatureMap&	EntityManager::getSignatureMap() const { return (signatureMap_); }
+
+const EntityPool&	EntityManager::getPool() const { return (pool_); }
+
+
+// Commands are sorted by order key, then by thread and recording order, which
+// a plain sort handles without the temporary buffer stable_sort allocates.
+void	EntityManager::applyCommands()
+{
+	commandOrder_.clear();
+	for (uint32_t buffer = 0; buffer < buffers_.size(); ++buffer)
+	{
+		const auto& commands = buffers_[buffer].commands_;
+		for (uint32_t index = 0; index < commands.size(); ++index)
+		{
+			commandOrder_.push_back(CommandRef{commands[index].order_, buffer, index});
+		}
+	}
+	if (commandOrder_.empty()) { return ; }
+
+	std::sort(commandOrder_.begin(), commandOrder_.end(), [](const CommandRef& lhs, const CommandRef& rhs)
+	{
+		return (std::tie(lhs.order_, lhs.buffer_, lhs.index_) < std::tie(rhs.order_, rhs.buffer_, rhs.index_));
+	});
+	for (const auto& ref : commandOrder_)
+	{
+		auto& buffer = buffers_[ref.buffer_];
+		const auto& command = buffer.commands_[ref.index_];
+		if (command.type_ == CommandBuffer::Command::Spawn)
+		{
+			const Entity entity = addEntity(command.tag_);
+			std::apply([&entity](const auto&... components) { (copyComponent(entity, components), ...); },
+						buffer.prototypes_[command.payload_]);
+		}
+		else if (command.type_ == CommandBuffer::Command::Destroy) { pool_.destroy(command.handle_); }
+		else if (pool_.isValid(command.handle_))
+		{
+			const Entity entity{pool_, command.handle_};
+			std::visit([&entity](const auto& component) { copyComponent(entity, component); }, buffer.components_[command.payload_]);
+			// Entities spawned this tick are bucketed when they are added; listed ones may change signature.
+			if (isListed(command.handle_)) { updateSignature(entity); }
+		}
+	}
+
+	for (auto& buffer : buffers_) { buffer.clear(); }
+}
+
+void	EntityManager::removeEntity(const uint32_t index)
+{
+	const auto& slot = pool_.slots_[index];
+
+	swapRemove(entities_, slot.listIndex_, &EntityPool::Slot::listIndex_);
+	swapRemove(entityMap_[static_cast<size_t>(slot.tag_)], slot.bucketIndex_, &EntityPool::Slot::bucketIndex_);
+	swapRemove(signatureMap_[slot.signature_], slot.signatureIndex_, &EntityPool::Slot::signatureIndex_);
+
+	pool_.release(EntityHandle{index, slot.generation_});
+}
+
+bool	EntityManager::isListed(const EntityHandle handle) const
+{
+	if (!pool_.isValid(handle)) { return (false); }
+
+	const uint32_t position = pool_.slots_[handle.index_].listIndex_;
+	return (position < entities_.size() && entities_[position].handle() == handle);
+}
+
+void	EntityManager::updateSignature(const Entity& entity)
+{
+	auto& slot = pool_.slots_[entity.handle().index_];
+	const uint32_t signature = signatureOf(entity, componentIndices);
+	if (signature == slot.signature_) { return ; }
+
+	swapRemove(signatureMap_[slot.signature_], slot.signatureIndex_, &EntityPool::Slot::signatureIndex_);
+	slot.signature_ = signature;
+	slot.signatureIndex_ = static_cast<uint32_t>(signatureMap_[signature].size());
+	signatureMap_[signature].push_back(entity);
+}
+
+// Swap-and-pop; the entity moved into the hole takes over its index.
+void	EntityManager::swapRemove(EntityVec& vec, const uint32_t position, uint32_t EntityPool::Slot::* field)
+{
+	vec[position] = vec.back();
+	pool_.slots_[vec[position].handle().index_].*field = position;
+	vec.pop_back();
+}
+
+void	EntityManager::saveSlot(SnapshotWriter& out, const EntityPool::Slot& slot)
+{
+	out.write(slot.generation_);
+	out.write(static_cast<uint8_t>(slot.active_));
+	out.write(static_cast<uint8_t>(slot.tag_));
+	out.write(static_cast<uint64_t>(slot.id_));
+	out.write(slot.listIndex_);
+	out.write(slot.bucketIndex_);
+	out.write(slot.signatureIndex_);
+	out.write(slot.signature_);
+}
+
+bool	EntityManager::loadSlot(SnapshotReader& in, EntityPool::Slot& slot)
+{
+	uint8_t active = 0;
+	uint8_t tag = 0;
+	uint64_t id = 0;
+	in.read(slot.generation_);
+	in.read(active);
+	in.read(tag);
+	in.read(id);
+	in.read(slot.listIndex_);
+	in.read(slot.bucketIndex_);
+	in.read(slot.signatureIndex_);
+	in.read(slot.signature_);
+	if (in.failed() || active > 1 || tag >= entityTagCount || slot.signature_ >= signatureCount) { return (false); }
 
-void	EntityManager::removeDeadEntities(EntityVec& vec)
+	slot.active_ = active == 1;
+	slot.tag_ = static_cast<EntityTag>(tag);
+	slot.id_ = static_cast<size_t>(id);
+
+	return (true);
+}
+
+// Every slot is saved, free ones included, so generations survive a round trip;
+// each live entity then follows in list order with its components.
+void	EntityManager::save(SnapshotWriter& out) const
 {
-	auto iter = std::remove_if(vec.begin(), vec.end(),
-								[](const std::shared_ptr<Entity>& entity)
-								{
-									return (entity->isActive() == false);
-								});
-	vec.erase(iter, vec.end());
+	assert(entitiesToAdd_.empty() && pool_.killCount_ == 0 && "snapshot taken with pending changes");
+
+	out.write(static_cast<uint64_t>(totalEntities_));
+	out.write(static_cast<uint32_t>(pool_.slots_.size()));
+	for (const auto& slot : pool_.slots_) { saveSlot(out, slot); }
+	out.write(static_cast<uint32_t>(pool_.freeSlots_.size()));
+	out.writeBytes(pool_.freeSlots_.data(), pool_.freeSlots_.size() * sizeof(uint32_t));
+	out.write(static_cast<uint32_t>(entities_.size()));
+	for (const auto& entity : entities_)
+	{
+		out.write(entity.handle().index_);
+		saveComponents(out, entity, componentIndices);
+	}
+}
+
+// Two passes: the first reads and checks everything into temporaries, the
+// second, only reached once the snapshot is known to be well formed, applies it.
+// A malformed snapshot therefore leaves the manager exactly as it was.
+bool	EntityManager::load(SnapshotReader& in)
+{
+	const MemoryScope scope{MemoryTag::Entities};
+	uint64_t totalEntities = 0;
+	uint32_t slotCount = 0;
+	in.read(totalEntities);
+	in.read(slotCount);
+	if (in.failed() || slotCount * slotBytes > in.remaining()) { return (false); }
+
+	std::vector<EntityPool::Slot> slots(slotCount);
+	for (auto& slot : slots)
+	{
+		if (!loadSlot(in, slot)) { return (false); }
+	}
+
+	uint32_t freeCount = 0;
+	in.read(freeCount);
+	if (in.failed() || freeCount > slotCount) { return (false); }
+	std::vector<uint32_t> freeSlots(freeCount);
+	in.readBytes(freeSlots.data(), freeCount * sizeof(uint32_t));
+
+	// Every slot is either free or holds one live entity.
+	uint32_t entityCount = 0;
+	in.read(entityCount);
+	if (in.failed() || entityCount != slotCount - freeCount) { return (false); }
+	std::vector<bool> freed(slotCount);
+	for (const auto index : freeSlots)
+	{
+		if (index >= slotCount || slots[index].active_ || freed[index]) { return (false); }
+		freed[index] = true;
+	}
+
+	SnapshotReader probe = in;
+	EntityVec entities;
+	entities.reserve(entityCount);
+	ComponentTuple components;
+	for (uint32_t i = 0; i < entityCount; ++i)
+	{
+		uint32_t index = 0;
+		probe.read(index);
+		if (probe.failed() || index >= slotCount) { return (false); }
+
+		const auto& slot = slots[index];
+		if (!slot.active_ || slot.listIndex_ != i || readComponents(probe, components, componentIndices) != slot.signature_) { return (false); }
+		entities.push_back(Entity{pool_, EntityHandle{index, slot.generation_}});
+	}
+
+	// Put every entity back at the position its slot recorded in each bucket; each position is taken exactly once.
+	const auto rebuild = [&](auto& buckets, const auto key, uint32_t EntityPool::Slot::* field)
+	{
+		for (const auto& entity : entities) { buckets[static_cast<size_t>(slots[entity.handle().index_].*key)].push_back(entity); }
+		for (auto& bucket : buckets)
+		{
+			std::fill(bucket.begin(), bucket.end(), Entity{pool_, EntityHandle{}});
+		}
+		for (const auto& entity : entities)
+		{
+			const auto& slot = slots[entity.handle().index_];
+			auto& bucket = buckets[static_cast<size_t>(slot.*key)];
+			if (slot.*field >= bucket.size() || bucket[slot.*field].handle() != EntityHandle{}) { return (false); }
+			bucket[slot.*field] = entity;
+		}
+
+		return (true);
+	};
+	EntityMap entityMap;
+	SignatureMap signatureMap;
+	if (!rebuild(entityMap, &EntityPool::Slot::tag_, &EntityPool::Slot::bucketIndex_)
+		|| !rebuild(signatureMap, &EntityPool::Slot::signature_, &EntityPool::Slot::signatureIndex_))
+	{
+		return (false);
+	}
+
+	for (auto& buffer : buffers_) { buffer.clear(); }
+	entitiesToAdd_.clear();
+	pool_.killCount_ = 0;
+	totalEntities_ = static_cast<size_t>(totalEntities);
+	pool_.slots_.assign(slots.begin(), slots.end());
+	pool_.freeSlots_.assign(freeSlots.begin(), freeSlots.end());
+	pool_.freeSlots_.reserve(pool_.slots_.capacity());
+	pool_.killList_.resize(slotCount);
+	pool_.components_.reserve(slotCount);
+	for (uint32_t i = 0; i < slotCount; ++i) { pool_.components_.clear(i); }
+	for (const auto& entity : entities)
+	{
+		uint32_t index = 0;
+		in.read(index);
+		readComponents(in, components, componentIndices);
+		std::apply([&entity](const auto&... component) { (copyComponent(entity, component), ...); }, components);
+	}
+	entities_.assign(entities.begin(), entities.end());
+	for (size_t tag = 0; tag < entityTagCount; ++tag) { entityMap_[tag].assign(entityMap[tag].begin(), entityMap[tag].end()); }
+	for (size_t bits = 0; bits < signatureCount; ++bits) { signatureMap_[bits].assign(signatureMap[bits].begin(), signatureMap[bits].end()); }
+
+	return (true);
 }
@@ -0,0 +1,38 @@
+#include "EntityPool.h"
+
+EntityHandle	EntityPool::create(const EntityTag tag, const size_t id)
+{
+	uint32_t index;
+	if (freeSlots_.empty())
+	{
+		index = static_cast<uint32_t>(slots_.size());
+		slots_.emplace_back();
+		killList_.resize(slots_.size());
+		components_.reserve(slots_.size());
+		// The free list never outgrows the slots; sized with them, release() never allocates.
+		freeSlots_.reserve(slots_.capacity());
+	}
+	else
+	{
+		index = freeSlots_.back();
+		freeSlots_.pop_back();
+	}
+
+	auto& slot = slots_[index];
+	slot.active_ = true;
+	slot.tag_ = tag;
+	slot.id_ = id;
+
+	return (EntityHandle{index, slot.generation_});
+}
+
+void	EntityPool::release(const EntityHandle handle)
+{
+	if (!isValid(handle)) { return ; }
+
+	auto& slot = slots_[handle.index_];
+	slot.active_ = false;
+	++slot.generation_;
+	components_.clear(handle.index_);
+	freeSlots_.push_back(handle.index_);
+}
@@ -0,0 +1,55 @@
+#include "FrameArena.h"
+
+#include <algorithm>
+#include <cassert>
+
+namespace
+{
+	size_t	blockUnits(const size_t bytes)
+	{
+		return ((bytes + sizeof(std::max_align_t) - 1) / sizeof(std::max_align_t));
+	}
+}
+
+FrameArena::FrameArena(const size_t capacity) :
+	block_{std::make_unique<std::max_align_t[]>(blockUnits(capacity))},
+	capacity_{blockUnits(capacity) * sizeof(std::max_align_t)}
+{
+}
+
+void*	FrameArena::allocate(const size_t bytes, const size_t alignment)
+{
+	assert(alignment <= alignof(std::max_align_t) && "over-aligned arena allocation");
+
+	auto* base = reinterpret_cast<std::byte*>(block_.get());
+	size_t offset = offset_.load(std::memory_order_relaxed);
+	while (true)
+	{
+		const size_t begin = (offset + alignment - 1) / alignment * alignment;
+		if (begin + bytes > capacity_) { break ; }
+		if (offset_.compare_exchange_weak(offset, begin + bytes, std::memory_order_relaxed)) { return (base + begin); }
+	}
+
+	// Out of room: leave the block exhausted so later calls come straight here.
+	offset_.store(capacity_ + 1, std::memory_order_relaxed);
+	const std::lock_guard<std::mutex> lock{overflowMutex_};
+	overflow_.push_back(std::make_unique<std::max_align_t[]>(blockUnits(bytes)));
+	overflowBytes_ += blockUnits(bytes) * sizeof(std::max_align_t);
+
+	return (overflow_.back().get());
+}
+
+void	FrameArena::reset()
+{
+	peak_ = std::max(peak_, used());
+	if (!overflow_.empty())
+	{
+		// Room for everything this tick needed, with slack for the next one.
+		const size_t units = blockUnits(std::max(capacity_ * 2, peak_ + peak_ / 2));
+		block_ = std::make_unique<std::max_align_t[]>(units);
+		capacity_ = units * sizeof(std::max_align_t);
+		overflow_.clear();
+		overflowBytes_ = 0;
+	}
+	offset_.store(0, std::memory_order_relaxed);
+}
@@ -1,18 +1,117 @@
 #include "Game.h"
 #include "ConfigLoader.h"
-#include "RandomGenerator.h"
+#include "AllocationCounter.h"
 #include <imgui.h>
 #include <imgui-SFML.h>
+#include <cassert>
 #include <cmath>
+#include <chrono>
+#include <algorithm>
+#include <new>
 
-Game::Game(const std::string& configPath)
+namespace
 {
-	init(configPath);
+	constexpr size_t	entityGrain = 2048;
+	constexpr size_t	bulletGrain = 64;
+
+	constexpr char		stateMagic[4] = {'G', 'W', 'S', 'S'};
+	constexpr uint32_t	stateVersion = 3;
+	constexpr char		stateFilePath[] = "savestate.gwss";
+	constexpr float		particleWidth = 2.0f;
+
+	// Components each view-driven system iterates over; the schedule derives the
+	// system's declared accesses from the same signature.
+	using TransformView = EntityView<TransformComponent>;
+	using LifespanView = EntityView<LifespanComponent, ShapeComponent>;
+
+	// ImGui allocates with malloc unless told otherwise; routed through operator new its memory is tracked.
+	void*	imguiAllocate(const size_t size, void*) { return (::operator new(size, std::nothrow)); }
+	void	imguiFree(void* pointer, void*) { ::operator delete(pointer); }
+
+	uint64_t	simulationAllocations()
+	{
+		return (AllocationCounter::stats(MemoryTag::Entities).allocations_ + AllocationCounter::stats(MemoryTag::Systems).allocations_);
+	}
+}
+
+Game::Game(const LaunchOptions& options)
+{
+	init(options);
+}
+
+void	Game::init(const LaunchOptions& options)
+{
+	StartupTimer startup;
+	Profiler::setThreadName("main");
+
+	gameConfig_ = ConfigLoader::loadFromFile(options.configPath_);
+	ConfigLoader::applyLaunchOptions(gameConfig_, options);
+	startup.mark("config");
+
+	auto& simulationConfig = gameConfig_.simulationConfig_;
+	if (options.replayPath_)
+	{
+		replay_ = std::make_unique<InputReplay>(*options.replayPath_);
+		const auto& header = replay_->header();
+		if (header.configHash_ != gameConfig_.hash_)
+		{
+			SPDLOG_WARN("Replay {} was recorded with a different config, the run will diverge", *options.replayPath_);
+		}
+		simulationConfig.seed_ = header.seed_;
+		simulationConfig.tickRate_ = static_cast<int>(header.tickRate_);
+		if (!options.frames_) { simulationConfig.frames_ = static_cast<int>(replay_->ticks()); }
+		SPDLOG_INFO("Replaying {} ticks from {}", replay_->ticks(), *options.replayPath_);
+	}
+	if (simulationConfig.seed_ == 0) { simulationConfig.seed_ = RandomGenerator::entropySeed(); }
+	random_.seed(simulationConfig.seed_);
+	SPDLOG_INFO("Random seed: {}", random_.seed());
+
+	if (options.loadStatePath_ && (options.recordPath_ || options.replayPath_))
+	{
+		SPDLOG_ERROR("--load-state cannot be combined with --record or --replay");
+		exit(1);
+	}
+	if (options.recordPath_)
+	{
+		recorder_ = std::make_unique<InputRecorder>(*options.recordPath_,
+						RecordingHeader{random_.seed(), gameConfig_.hash_, static_cast<uint32_t>(simulationConfig.tickRate_)});
+	}
+
+	SPDLOG_INFO("Motion kernels: {}", MotionKernels::isaName(MotionKernels::activeIsa()));
+
+	jobs_ = std::make_unique<JobSystem>(static_cast<size_t>(gameConfig_.simulationConfig_.workers_));
+	entities_.setThreadCount(jobs_->threadCount());
+	buildSchedule();
+	SPDLOG_INFO("Job system: {} threads, schedule {}", jobs_->threadCount(), schedule_.describe());
+	startup.mark("jobs");
+
+	headless_ = gameConfig_.simulationConfig_.headless_;
+	reportPath_ = options.reportPath_;
+	if (!headless_) { initWindow(startup); }
+
+	spawnPlayer();
+	spawnScenario();
+	// The first tick applies input before entities_.update(), so the player must already be live.
+	entities_.update();
+	if (options.loadStatePath_ && !loadStateFile(*options.loadStatePath_)) { exit(1); }
+	startup.mark("world");
+
+	// Headless runs cannot rewind; with --snapshots they keep a single snapshot just to measure its cost.
+	if (simulationConfig.snapshotSeconds_ > 0 && (!headless_ || simulationConfig.headlessSnapshots_))
+	{
+		const int ringSize = simulationConfig.snapshotSeconds_ * simulationConfig.tickRate_ / simulationConfig.snapshotInterval_;
+		snapshots_.reset(headless_ ? 1 : static_cast<size_t>(std::max(1, ringSize)));
+		captureSnapshot();
+	}
+	startup.log();
 }
 
-void	Game::init(const std::string& configPath)
+// Fonts load on a background thread while the window is created.
+void	Game::initWindow(StartupTimer& startup)
 {
-	gameConfig_ = ConfigLoader::loadFromFile(configPath);
+	const MemoryScope scope{MemoryTag::Sfml};
+	hud_.requestFonts(resources_, gameConfig_.uiConfig_);
+	resources_.loadAsync();
 
 	unsigned int windowWidth = gameConfig_.windowConfig_.width_;
 	unsigned int windowHeight = gameConfig_.windowConfig_.height_;
@@ -22,105 +121,392 @@ void	Game::init(const std::string& configPath)
 
 	unsigned int frameLimit = gameConfig_.windowConfig_.frameLimit_;
 	window_.setFramerateLimit(frameLimit);
+	startup.mark("window");
 
-	initText(scoreText_, scoreFont_, gameConfig_.uiConfig_.score_, "");
-	initText(highScoreText_, highScoreFont_, gameConfig_.uiConfig_.highScore_, "");
-	initText(specialWeaponText_, specialWeaponFont_, gameConfig_.uiConfig_.specialWeapon_, specialWeaponAvailable_);
-	initText(pauseText_, pauseFont_, gameConfig_.uiConfig_.pause_, pause_);
+	resources_.wait();
+	startup.mark("fonts");
 
-	ImGui::SFML::Init(window_);
+	hud_.init(resources_, gameConfig_);
+	startup.mark("hud");
 
-	spawnPlayer();
-}
+	particles_.reset(gameConfig_.particleConfig_.capacity_);
 
-void	Game::initText(sf::Text& text, sf::Font& font, const Font& fontConfig, const std::string& str)
-{
-	if (!font.loadFromFile(fontConfig.path_))
 	{
-		SPDLOG_ERROR("Could not load font: {}", fontConfig.path_);
-		exit(1);
+		const MemoryScope imguiScope{MemoryTag::ImGui};
+		if constexpr (AllocationCounter::tracking) { ImGui::SetAllocatorFunctions(imguiAllocate, imguiFree); }
+		ImGui::SFML::Init(window_);
 	}
-	text.setFont(font);
-	text.setString(str);
-	text.setCharacterSize(fontConfig.size_);
-	text.setFillColor(fontConfig.color_);
-	text.setPosition(sf::Vector2f{gameConfig_.windowConfig_.width_ * fontConfig.pos_.x_ - text.getGlobalBounds().width / 2.0f,
-										gameConfig_.windowConfig_.height_ * fontConfig.pos_.y_ - text.getCharacterSize() / 2.0f});
+	startup.mark("imgui");
+
+	const auto& simulationConfig = gameConfig_.simulationConfig_;
+	if (simulationConfig.inputThread_ && !replay_)
+	{
+		inputThread_ = std::make_unique<InputThread>(window_, simulationConfig.inputPollHz_);
+		inputThread_->setFocused(window_.hasFocus());
+	}
+	guiSettings_ = GuiSettings{imGuiConfig_, gameConfig_.collisionConfig_.spatialGrid_, gameConfig_.enemyConfig_.spawnInterval_};
 }
 
-void	Game::run()
+int		Game::run()
 {
+	if (headless_) { return (runHeadless()); }
+
+	const auto& simulationConfig = gameConfig_.simulationConfig_;
+	const double tickSeconds = 1.0 / simulationConfig.tickRate_;
+	const int maxTicks = simulationConfig.maxTicksPerFrame_;
+
+	double accumulator = 0.0;
+	auto previousTime = std::chrono::steady_clock::now();
+	publishRender(previousTime, accumulator);
+	if (simulationConfig.renderThread_)
+	{
+		// The window's GL context can only be current on one thread.
+		window_.setActive(false);
+		renderThread_ = std::thread{[this] { renderLoop(); }};
+	}
+
 	while (running_)
 	{
-		entities_.update();
-		ImGui::SFML::Update(window_, deltaClock_.restart());
+		Profiler::beginFrame();
+		const auto now = std::chrono::steady_clock::now();
+		accumulator += std::chrono::duration<double>(now - previousTime).count();
+		previousTime = now;
 
 		inputSystem();
-		enemySpawnerSystem();
-		movementSystem();
-		collisionSystem();
-		lifespanSystem();
-		GUISystem();
-		renderSystem();
+		applyGuiChanges();
 
-		if (paused_) { continue ; }
-		if (++currentFrame_ - lastSpecialWeaponTime_ > 900) { isSpecialWeaponAvailable_ = true; }
+		// At most maxTicks per frame; a backlog beyond that is dropped so a slow
+		// frame cannot make the next one even slower.
+		int ticks = 0;
+		while (accumulator >= tickSeconds && ticks < maxTicks)
+		{
+			step();
+			captureDueSnapshot();
+			accumulator -= tickSeconds;
+			++ticks;
+		}
+		if (ticks == maxTicks) { accumulator = std::min(accumulator, tickSeconds); }
+
+		publishRender(now, accumulator);
+		Profiler::endFrame();
+		// With a render thread the loop only has to wake up for the next tick.
+		if (renderThread_.joinable()) { std::this_thread::sleep_until(now + std::chrono::duration<double>(tickSeconds - accumulator)); }
+		else { renderFrame(); }
 	}
 
+	if (renderThread_.joinable())
+	{
+		renderStopping_.store(true, std::memory_order_relaxed);
+		renderThread_.join();
+		window_.setActive(true);
+	}
+	inputThread_.reset();
 	window_.close();
+
+	return (0);
+}
+
+void	Game::buildSchedule()
+{
+	// Every system checks paused_ and its ImGui toggle, so each reads gameStateBit.
+	schedule_.add("spawner", SystemAccess{componentBits<TransformComponent>() | gameStateBit, allComponentBits | lifetimeBit | gameStateBit},
+					[this] { enemySpawnerSystem(); });
+	schedule_.add("movement", SystemAccess{componentBits<InputComponent, CollisionComponent>() | gameStateBit, TransformView::signature},
+					[this] { movementSystem(); });
+	schedule_.add("collision", SystemAccess{componentBits<CollisionComponent, ShapeComponent>() | gameStateBit,
+											allComponentBits | lifetimeBit | gameStateBit},
+					[this] { collisionSystem(); });
+	schedule_.add("lifespan", SystemAccess{gameStateBit, LifespanView::signature | lifetimeBit},
+					[this] { lifespanSystem(); });
+}
+
+int		Game::runHeadless()
+{
+	const int frames = gameConfig_.simulationConfig_.frames_;
+	const int steadyStateFrame = gameConfig_.scenarioConfig_.steadyStateFrame_;
+	RunReport report{gameConfig_.scenarioConfig_};
+	report.reserve(static_cast<size_t>(std::max(0, frames)));
+
+	const auto start = std::chrono::steady_clock::now();
+	int frame = 0;
+	for (; frame < frames && running_; ++frame)
+	{
+		Profiler::beginFrame();
+		const AllocationScope allocations;
+		const auto frameStart = std::chrono::steady_clock::now();
+		step();
+		const auto frameEnd = std::chrono::steady_clock::now();
+		assert((frame < steadyStateFrame || steadyStateFrame < 0 || allocations.allocations() == 0) && "steady-state tick allocated");
+		report.addFrame(std::chrono::duration<float, std::milli>(frameEnd - frameStart).count(),
+						entities_.getEntities().size(), entities_.getPool().bytes(), allocations.allocations());
+
+		// Kept out of the frame time, which measures the simulation alone.
+		captureDueSnapshot();
+		Profiler::endFrame();
+	}
+	const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+	const double seconds = elapsed.count();
+	SPDLOG_INFO("Headless run: {} frames in {:.3f} s ({:.1f} frames/s, {:.3f} ms/frame), {} entities alive",
+				frame, seconds, seconds > 0.0 ? frame / seconds : 0.0,
+				frame > 0 ? seconds * 1000.0 / frame : 0.0, entities_.getEntities().size());
+	Profiler::logSummary();
+	if (snapshotCount_ > 0)
+	{
+		SPDLOG_INFO("Snapshots: {} taken, {:.1f} us avg, {:.1f} us last, {} bytes last",
+					snapshotCount_, snapshotTotalMicros_ / snapshotCount_, snapshotMicros_, snapshots_.back(0).size());
+	}
+	SPDLOG_INFO("Frame arena: peak {:.1f} KiB of {:.1f} KiB", frameArena_.peak() / 1024.0, frameArena_.capacity() / 1024.0);
+
+	const RunSummary summary = report.summarize();
+	report.log(summary);
+	if (reportPath_ && !report.write(*reportPath_, summary)) { return (1); }
+
+	return (report.withinBudget(summary) ? 0 : 1);
+}
+
+void	Game::step()
+{
+	const MemoryScope scope{MemoryTag::Systems};
+	const uint64_t allocationsBefore = simulationAllocations();
+	frameArena_.reset();
+	if (inputThread_) { drainInput(); }
+	// Applied in place rather than copied, so the action list keeps its capacity.
+	if (replay_) { replay_->next(pendingInput_); }
+	if (recorder_) { recorder_->write(pendingInput_); }
+	applyInput(pendingInput_);
+	pendingInput_.actions_.clear();
+	if (replay_ && replay_->finished()) { running_ = false; }
+
+	// The previous tick ended with an update, so only input and GUI actions can have queued changes.
+	if (entities_.hasPendingChanges())
+	{
+		PROFILE_SCOPE(ProfileZone::EntityUpdate);
+		entities_.update();
+	}
+
+	TransformView{entities_}.each([](const Entity&, TransformComponent& transform)
+	{
+		transform.prevPos_ = transform.pos_;
+		transform.prevAngle_ = transform.angle_;
+	});
+
+	schedule_.run(*jobs_);
+	particleSystem();
+
+	if (!paused_ && ++currentFrame_ - lastSpecialWeaponTime_ > 900) { isSpecialWeaponAvailable_ = true; }
+
+	// Apply this tick's spawns and kills now, so snapshots and rendering never see pending changes.
+	{
+		PROFILE_SCOPE(ProfileZone::EntityUpdate);
+		entities_.update();
+	}
+	tickAllocations_ = simulationAllocations() - allocationsBefore;
+}
+
+// Runs after step(), so a headless run can keep the capture out of the tick it measures.
+void	Game::captureDueSnapshot()
+{
+	if (!paused_ && currentFrame_ % gameConfig_.simulationConfig_.snapshotInterval_ == 0) { captureSnapshot(); }
+}
+
+void	Game::captureSnapshot()
+{
+	if (snapshots_.capacity() == 0) { return ; }
+
+	PROFILE_SCOPE(ProfileZone::Snapshot);
+	const auto start = std::chrono::steady_clock::now();
+	saveState(snapshots_.push());
+	snapshotMicros_ = std::chrono::duration<float, std::micro>(std::chrono::steady_clock::now() - start).count();
+	snapshotTotalMicros_ += snapshotMicros_;
+	++snapshotCount_;
+}
+
+// Binary layout (native byte order, see Snapshot.h):
+//   "GWSS" u32 version, u64 configHash, game state, random streams, EntityManager::save
+void	Game::saveState(std::vector<char>& data) const
+{
+	SnapshotWriter out{data};
+	out.writeBytes(stateMagic, sizeof(stateMagic));
+	out.write(stateVersion);
+	out.write(gameConfig_.hash_);
+	out.write(score_);
+	out.write(highScore_);
+	out.write(currentFrame_);
+	out.write(lastEnemySpawnTime_);
+	out.write(lastSpecialWeaponTime_);
+	out.write(isSpecialWeaponAvailable_);
+	out.write(paused_);
+	out.write(random_);
+	entities_.save(out);
+}
+
+bool	Game::loadState(const std::vector<char>& data)
+{
+	SnapshotReader in{data};
+	char fileMagic[sizeof(stateMagic)] = {};
+	uint32_t fileVersion = 0;
+	uint64_t configHash = 0;
+	in.readBytes(fileMagic, sizeof(fileMagic));
+	in.read(fileVersion);
+	in.read(configHash);
+	if (in.failed() || !std::equal(std::begin(stateMagic), std::end(stateMagic), fileMagic))
+	{
+		SPDLOG_WARN("Not a save-state");
+		return (false);
+	}
+	if (fileVersion != stateVersion)
+	{
+		SPDLOG_WARN("Unsupported save-state version {} (expected {})", fileVersion, stateVersion);
+		return (false);
+	}
+	if (configHash != gameConfig_.hash_)
+	{
+		SPDLOG_WARN("Save-state was written with a different config");
+		return (false);
+	}
+
+	// Read into locals so a corrupt save-state leaves the game as it was; entities_.load() does the same.
+	size_t score = 0;
+	size_t highScore = 0;
+	int currentFrame = 0;
+	int lastEnemySpawnTime = 0;
+	int lastSpecialWeaponTime = 0;
+	bool isSpecialWeaponAvailable = false;
+	bool paused = false;
+	RandomGenerator random = random_;
+	in.read(score);
+	in.read(highScore);
+	in.read(currentFrame);
+	in.read(lastEnemySpawnTime);
+	in.read(lastSpecialWeaponTime);
+	in.read(isSpecialWeaponAvailable);
+	in.read(paused);
+	in.read(random);
+	if (in.failed() || !entities_.load(in))
+	{
+		SPDLOG_WARN("Truncated or corrupt save-state");
+		return (false);
+	}
+	score_ = score;
+	highScore_ = highScore;
+	currentFrame_ = currentFrame;
+	lastEnemySpawnTime_ = lastEnemySpawnTime;
+	lastSpecialWeaponTime_ = lastSpecialWeaponTime;
+	isSpecialWeaponAvailable_ = isSpecialWeaponAvailable;
+	paused_ = paused;
+	random_ = random;
+	pendingInput_.actions_.clear();
+	particles_.clear();
+
+	return (true);
+}
+
+// age counts snapshots back from the newest; later snapshots are discarded.
+// A snapshot that fails to load leaves both the game and the ring untouched.
+void	Game::rewind(const size_t age)
+{
+	if (!canRestore() || age >= snapshots_.size()) { return ; }
+
+	if (!loadState(snapshots_.back(age)))
+	{
+		SPDLOG_ERROR("Failed to rewind {} snapshots", age);
+		return ;
+	}
+	snapshots_.drop(age);
+	rewindAge_ = 0;
+}
+
+void	Game::saveStateFile(const std::string& path)
+{
+	// GUI actions between ticks may have queued spawns.
+	entities_.update();
+	saveState(stateFile_);
+	if (!writeSnapshotFile(path, stateFile_))
+	{
+		SPDLOG_WARN("Failed to write save-state: {}", path);
+		return ;
+	}
+	SPDLOG_INFO("Saved frame {} ({} bytes) to {}", currentFrame_, stateFile_.size(), path);
+}
+
+// A failed load leaves the game as it was.
+bool	Game::loadStateFile(const std::string& path)
+{
+	if (!canRestore())
+	{
+		SPDLOG_WARN("Loading a save-state is disabled while recording or replaying");
+		return (false);
+	}
+	if (!readSnapshotFile(path, stateFile_))
+	{
+		SPDLOG_ERROR("Failed to open save-state: {}", path);
+		return (false);
+	}
+
+	if (!loadState(stateFile_))
+	{
+		SPDLOG_ERROR("Failed to load save-state: {}", path);
+		return (false);
+	}
+	snapshots_.drop(snapshots_.size());
+	captureSnapshot();
+	SPDLOG_INFO("Loaded frame {} from {}", currentFrame_, path);
+
+	return (true);
 }
 
 void	Game::spawnPlayer()
 {
-	auto& player = entities_.addEntity("player");
+	auto player = entities_.addEntity(EntityTag::Player);
 
 	const auto& playerConfig = gameConfig_.playerConfig_;
 	const auto& windowConfig = gameConfig_.windowConfig_;
 	Vec2f playerPos{windowConfig.width_ * playerConfig.pos_.x_, windowConfig.height_ * playerConfig.pos_.y_};
-	player->addComponent<TransformComponent>(playerPos, playerConfig.velocity_, 0.0f);
-	player->addComponent<ShapeComponent>(playerConfig.shapeRadius_, playerConfig.vertices_, playerConfig.fillColor_,
+	player.addComponent<TransformComponent>(playerPos, playerConfig.velocity_, 0.0f);
+	player.addComponent<ShapeComponent>(playerConfig.shapeRadius_, playerConfig.vertices_, playerConfig.fillColor_,
 											playerConfig.outlineColor_, playerConfig.outlineThickness_);
-	player->addComponent<CollisionComponent>(playerConfig.collisionRadius_);
-	player->addComponent<InputComponent>();
+	player.addComponent<CollisionComponent>(playerConfig.collisionRadius_);
+	player.addComponent<InputComponent>();
 }
 
 void	Game::spawnEnemy()
 {
-	auto& enemy = entities_.addEntity("enemy");
+	auto enemy = entities_.commands().spawn(EntityTag::Enemy);
 
 	const auto&	enemyConfig = gameConfig_.enemyConfig_;
-	Vec2f		enemyPos = RandomGenerator::getRandomEnemyPos(gameConfig_, player()->getComponent<TransformComponent>().pos_);
-	Vec2f		enemySpeed = RandomGenerator::getRandomEnemySpeed(gameConfig_);
-	sf::Color	enemyColor = RandomGenerator::getRandomEnemyColor();
-	size_t		enemyPointCount = RandomGenerator::getRandomEnemyPointCount(gameConfig_);
+	Vec2f		enemyPos = random_.getRandomEnemyPos(gameConfig_, player().getComponent<TransformComponent>().pos_);
+	Vec2f		enemySpeed = random_.getRandomEnemySpeed(gameConfig_);
+	sf::Color	enemyColor = random_.getRandomEnemyColor();
+	size_t		enemyPointCount = random_.getRandomEnemyPointCount(gameConfig_);
 	
-	enemy->addComponent<TransformComponent>(enemyPos, enemySpeed, 0.0f);
-	enemy->addComponent<ShapeComponent>(enemyConfig.shapeRadius_, enemyPointCount, enemyColor, enemyConfig.outlineColor_, enemyConfig.outlineThickness_);
-	enemy->addComponent<CollisionComponent>(enemyConfig.collisionRadius_);
+	enemy.addComponent<TransformComponent>(enemyPos, enemySpeed, 0.0f);
+	enemy.addComponent<ShapeComponent>(enemyConfig.shapeRadius_, enemyPointCount, enemyColor, enemyConfig.outlineColor_, enemyConfig.outlineThickness_);
+	enemy.addComponent<CollisionComponent>(enemyConfig.collisionRadius_);
 
 	lastEnemySpawnTime_ = currentFrame_;
 }
 
-void	Game::spawnSmallEnemies(std::shared_ptr<Entity> entity)
+void	Game::spawnSmallEnemies(const Entity& entity)
 {
-	const size_t vertices = entity->getComponent<ShapeComponent>().circle_.getPointCount();
-	const auto pos = entity->getComponent<TransformComponent>().pos_;
-	const float speed = std::max(entity->getComponent<TransformComponent>().velocity_.x_, entity->getComponent<TransformComponent>().velocity_.y_);
-	const float radius = entity->getComponent<ShapeComponent>().circle_.getRadius() / 2.0f;
-	const auto fillColor = entity->getComponent<ShapeComponent>().circle_.getFillColor();
-	const auto outlineColor = entity->getComponent<ShapeComponent>().circle_.getOutlineColor();
-	const auto thickness = entity->getComponent<ShapeComponent>().circle_.getOutlineThickness();
+	const size_t vertices = entity.getComponent<ShapeComponent>().pointCount_;
+	const auto pos = entity.getComponent<TransformComponent>().pos_;
+	const float speed = std::max(entity.getComponent<TransformComponent>().velocity_.x_, entity.getComponent<TransformComponent>().velocity_.y_);
+	const float radius = entity.getComponent<ShapeComponent>().radius_ / 2.0f;
+	const auto fillColor = entity.getComponent<ShapeComponent>().fillColor_;
+	const auto outlineColor = entity.getComponent<ShapeComponent>().outlineColor_;
+	const auto thickness = entity.getComponent<ShapeComponent>().outlineThickness_;
 	const float pi = 3.1415f;
 	const float degrees = 360.0f / vertices;
 	const float radians = degrees * pi / 180.0f;
 	for (size_t i = 0; i < vertices; ++i)
 	{
-		auto& smallEnemy = entities_.addEntity("smallEnemy");
-		Vec2f direction{std::cosf(radians * i), std::sinf(radians * i)};
-		smallEnemy->addComponent<TransformComponent>(pos, direction.normalize() * speed, 0.0f);
-		smallEnemy->addComponent<ShapeComponent>(radius, vertices, fillColor,outlineColor, thickness);
-		smallEnemy->addComponent<CollisionComponent>(radius);
-		smallEnemy->addComponent<LifespanComponent>(gameConfig_.enemyConfig_.smallEnemyLifespan_);
+		auto smallEnemy = entities_.commands().spawn(EntityTag::SmallEnemy);
+		Vec2f direction{std::cos(radians * i), std::sin(radians * i)};
+		smallEnemy.addComponent<TransformComponent>(pos, direction.normalize() * speed, 0.0f);
+		smallEnemy.addComponent<ShapeComponent>(radius, vertices, fillColor,outlineColor, thickness);
+		smallEnemy.addComponent<CollisionComponent>(radius);
+		smallEnemy.addComponent<LifespanComponent>(gameConfig_.enemyConfig_.smallEnemyLifespan_);
 	}
 }
 
@@ -129,11 +515,11 @@ void	Game::spawnBullet(const Vec2f& startPos, const Vec2f& targetPos)
 	if (paused_) { return ; }
 	
 	const auto& bulletConfig = gameConfig_.bulletConfig_;
-	auto& bullet = entities_.addEntity("bullet");
-	bullet->addComponent<TransformComponent>(startPos, (targetPos - startPos).normalize() * bulletConfig.speed_, 0.0f);
-	bullet->addComponent<ShapeComponent>(bulletConfig.shapeRadius_, bulletConfig.vertices_, bulletConfig.fillColor_, bulletConfig.outlineColor_, bulletConfig.outlineThickness_);
-	bullet->addComponent<CollisionComponent>(bulletConfig.collisionRadius_);
-	bullet->addComponent<LifespanComponent>(bulletConfig.lifespan_);
+	auto bullet = entities_.commands().spawn(EntityTag::Bullet);
+	bullet.addComponent<TransformComponent>(startPos, (targetPos - startPos).normalize() * bulletConfig.speed_, 0.0f);
+	bullet.addComponent<ShapeComponent>(bulletConfig.shapeRadius_, bulletConfig.vertices_, bulletConfig.fillColor_, bulletConfig.outlineColor_, bulletConfig.outlineThickness_);
+	bullet.addComponent<CollisionComponent>(bulletConfig.collisionRadius_);
+	bullet.addComponent<LifespanComponent>(bulletConfig.lifespan_);
 }
 
 void	Game::specialWeapon(const Vec2f& playerPos)
@@ -146,7 +532,7 @@ void	Game::specialWeapon(const Vec2f& playerPos)
     
     for (int i = 0; i < 36; ++i)
     {
-        Vec2f direction{std::cosf(radians * i), std::sinf(radians * i)};
+        Vec2f direction{std::cos(radians * i), std::sin(radians * i)};
         
         for (int j = 0; j < 5; ++j)
         {
@@ -160,35 +546,114 @@ void	Game::specialWeapon(const Vec2f& playerPos)
 	isSpecialWeaponAvailable_ = false;
 }
 
+void	Game::spawnScenario()
+{
+	const auto& scenario = gameConfig_.scenarioConfig_;
+	if (!scenario.spawning_) { imGuiConfig_.spawning_ = false; }
+
+	spawnGroup(EntityTag::Enemy, scenario.enemies_);
+	spawnGroup(EntityTag::SmallEnemy, scenario.smallEnemies_);
+	spawnGroup(EntityTag::Bullet, scenario.bullets_);
+
+	const size_t total = scenario.enemies_.count_ + scenario.smallEnemies_.count_ + scenario.bullets_.count_;
+	if (total > 0 || !scenario.volleys_.empty())
+	{
+		SPDLOG_INFO("Scenario {}: {} enemies, {} small enemies, {} bullets, {} volleys", scenario.name_,
+					scenario.enemies_.count_, scenario.smallEnemies_.count_, scenario.bullets_.count_, scenario.volleys_.size());
+	}
+}
+
+void	Game::spawnGroup(const EntityTag tag, const SpawnGroupConfig& group)
+{
+	const auto& enemyConfig = gameConfig_.enemyConfig_;
+	const auto& bulletConfig = gameConfig_.bulletConfig_;
+
+	int lifespan = group.lifespan_;
+	float radius = enemyConfig.shapeRadius_;
+	float collisionRadius = enemyConfig.collisionRadius_;
+	if (tag == EntityTag::SmallEnemy)
+	{
+		if (lifespan < 0) { lifespan = enemyConfig.smallEnemyLifespan_; }
+		radius /= 2.0f;
+		collisionRadius = radius;
+	}
+	else if (tag == EntityTag::Bullet)
+	{
+		if (lifespan < 0) { lifespan = bulletConfig.lifespan_; }
+		radius = bulletConfig.shapeRadius_;
+		collisionRadius = bulletConfig.collisionRadius_;
+	}
+
+	for (size_t i = 0; i < group.count_; ++i)
+	{
+		auto entity = entities_.addEntity(tag);
+		entity.addComponent<TransformComponent>(random_.getScenarioPos(group, gameConfig_, radius), random_.getScenarioVelocity(group), 0.0f);
+		if (tag == EntityTag::Bullet)
+		{
+			entity.addComponent<ShapeComponent>(radius, bulletConfig.vertices_, bulletConfig.fillColor_,
+												bulletConfig.outlineColor_, bulletConfig.outlineThickness_);
+		}
+		else
+		{
+			entity.addComponent<ShapeComponent>(radius, random_.getScenarioPointCount(group), random_.getRandomEnemyColor(),
+												enemyConfig.outlineColor_, enemyConfig.outlineThickness_);
+		}
+		entity.addComponent<CollisionComponent>(collisionRadius);
+		if (lifespan > 0) { entity.addComponent<LifespanComponent>(lifespan); }
+	}
+}
+
+// Bullets leave the player evenly spaced on a circle, like the special weapon.
+void	Game::fireVolley(const VolleyConfig& volley)
+{
+	const Vec2f playerPos = player().getComponent<TransformComponent>().pos_;
+	const float radians = 2.0f * 3.1415f / std::max<size_t>(volley.bullets_, 1);
+	for (size_t i = 0; i < volley.bullets_; ++i)
+	{
+		Vec2f direction{std::cos(radians * i), std::sin(radians * i)};
+		spawnBullet(playerPos + direction * 20.0f, playerPos + direction * 1000.0f);
+	}
+	for (size_t i = 0; i < volley.enemies_; ++i) { spawnEnemy(); }
+}
+
 void	Game::inputSystem()
 {
+	PROFILE_SCOPE(ProfileZone::Input);
+	const MemoryScope scope{MemoryTag::Sfml};
 	sf::Event event;
 	while (window_.pollEvent(event))
 	{
-		ImGui::SFML::ProcessEvent(window_, event);
-		auto& playerInput = player()->getComponent<InputComponent>();
+		windowEvents_.push(event);
 		if (event.type == sf::Event::Closed) { running_ = false; }
-		else if (event.type == sf::Event::KeyPressed)
+		else if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::Escape) { running_ = false; }
+		else if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::F9) { Profiler::writeChromeTrace("trace.json"); }
+		else if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::F5) { saveStateFile(stateFilePath); }
+		else if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::F6) { loadStateFile(stateFilePath); }
+		else if (event.type == sf::Event::GainedFocus && inputThread_) { inputThread_->setFocused(true); }
+		else if (event.type == sf::Event::LostFocus && inputThread_) { inputThread_->setFocused(false); }
+
+		// A replay drives the player from the recording and the input thread samples the
+		// player's keys itself; either way the window only stays responsive.
+		if (replay_ || inputThread_) { continue ; }
+
+		if (event.type == sf::Event::KeyPressed)
 		{
 			switch (event.key.code)
 			{
 				case sf::Keyboard::W:
-					playerInput.up_ = true;
+					pendingInput_.up_ = true;
 					break ;
 				case sf::Keyboard::S:
-					playerInput.down_ = true;
+					pendingInput_.down_ = true;
 					break ;
 				case sf::Keyboard::A:
-					playerInput.left_ = true;
+					pendingInput_.left_ = true;
 					break ;
 				case sf::Keyboard::D:
-					playerInput.right_ = true;
+					pendingInput_.right_ = true;
 					break ;
 				case sf::Keyboard::P:
-					paused_ = !paused_;
-					break ;
-				case sf::Keyboard::Escape:
-					running_ = false;
+					pendingInput_.actions_.push_back(InputAction{InputAction::TogglePause, Vec2i{}});
 					break ;
 			}
 		}
@@ -197,38 +662,96 @@ void	Game::inputSystem()
 			switch (event.key.code)
 			{
 				case sf::Keyboard::W:
-					playerInput.up_ = false;
+					pendingInput_.up_ = false;
 					break ;
 				case sf::Keyboard::S:
-					playerInput.down_ = false;
+					pendingInput_.down_ = false;
 					break ;
 				case sf::Keyboard::A:
-					playerInput.left_ = false;
+					pendingInput_.left_ = false;
 					break ;
 				case sf::Keyboard::D:
-					playerInput.right_ = false;
+					pendingInput_.right_ = false;
 					break ;
 			}
 		}
 		else if (event.type == sf::Event::MouseButtonPressed)
 		{
-			if (ImGui::GetIO().WantCaptureMouse) { continue ; }
+			if (guiWantsMouse_.load(std::memory_order_relaxed)) { continue ; }
 
+			const Vec2i target{event.mouseButton.x, event.mouseButton.y};
 			if (event.mouseButton.button == sf::Mouse::Left)
 			{
-				spawnBullet(player()->getComponent<TransformComponent>().pos_, Vec2i{event.mouseButton.x, event.mouseButton.y});
+				pendingInput_.actions_.push_back(InputAction{InputAction::Shoot, target});
 			}
 			else if (event.mouseButton.button == sf::Mouse::Right)
 			{
-				specialWeapon(player()->getComponent<TransformComponent>().pos_);
+				pendingInput_.actions_.push_back(InputAction{InputAction::SpecialWeapon, target});
 			}
 		}
 	}
 }
 
+// Applies everything the input thread saw since the last tick, in order.
+void	Game::drainInput()
+{
+	const auto now = InputEvent::Clock::now();
+	InputEvent event;
+	while (inputThread_->poll(event))
+	{
+		if (event.type_ == InputEvent::Buttons) { pendingInput_.setButtons(event.buttons_); }
+		else if (event.action_.type_ != InputAction::TogglePause && guiWantsMouse_.load(std::memory_order_relaxed)) { continue ; }
+		else { pendingInput_.actions_.push_back(event.action_); }
+
+		inputToSimLatency_.add(event.time_, now);
+		// Presented once a render snapshot newer than the current one is on screen.
+		inputsToPresent_.push(PendingInput{renderSequence_ + 1, event.time_});
+	}
+}
+
+void	Game::applyInput(const InputFrame& input)
+{
+	auto playerEntity = player();
+	auto& playerInput = playerEntity.getComponent<InputComponent>();
+	playerInput.up_ = input.up_;
+	playerInput.down_ = input.down_;
+	playerInput.left_ = input.left_;
+	playerInput.right_ = input.right_;
+
+	const Vec2f playerPos = playerEntity.getComponent<TransformComponent>().pos_;
+	for (const auto& action : input.actions_)
+	{
+		switch (action.type_)
+		{
+			case InputAction::Shoot:
+				spawnBullet(playerPos, action.target_);
+				break ;
+			case InputAction::SpecialWeapon:
+				specialWeapon(playerPos);
+				break ;
+			case InputAction::TogglePause:
+				paused_ = !paused_;
+				break ;
+		}
+	}
+}
+
 void	Game::enemySpawnerSystem()
 {
-	if (paused_ || !imGuiConfig_.spawning_) { return ; }
+	PROFILE_SCOPE(ProfileZone::Spawner);
+	if (paused_) { return ; }
+
+	for (const auto& volley : gameConfig_.scenarioConfig_.volleys_)
+	{
+		const int elapsed = currentFrame_ - volley.frame_;
+		if (elapsed < 0) { continue ; }
+		if (volley.interval_ == 0 ? elapsed == 0 : (elapsed % volley.interval_ == 0 && elapsed / volley.interval_ < volley.repeat_))
+		{
+			fireVolley(volley);
+		}
+	}
+
+	if (!imGuiConfig_.spawning_) { return ; }
 
 	if (gameConfig_.enemyConfig_.spawnInterval_ <= currentFrame_ - lastEnemySpawnTime_)
 	{
@@ -238,145 +761,393 @@ void	Game::enemySpawnerSystem()
 
 void	Game::movementSystem()
 {
-	auto entities = entities_.getEntities();
-	for (auto& entity : entities) { entity->getComponent<TransformComponent>().angle_ += 1.0f; }
+	PROFILE_SCOPE(ProfileZone::Movement);
+	const TransformView transforms{entities_};
+	jobs_->parallelFor(transforms.size(), entityGrain, [&transforms](const size_t begin, const size_t end)
+	{
+		transforms.each(begin, end, [](const Entity&, TransformComponent& transform) { transform.angle_ += 1.0f; });
+	});
 
 	if (paused_ || !imGuiConfig_.movement_) { return ; }
 
-	auto& playerEntity = player();
-	auto& playerVelocity = playerEntity->getComponent<TransformComponent>().velocity_;
+	auto playerEntity = player();
+	auto& playerVelocity = playerEntity.getComponent<TransformComponent>().velocity_;
 	Vec2f movement{0.0f, 0.0f};
-	for (auto& entity : entities)
+	if (playerEntity.getComponent<InputComponent>().up_) { movement.y_ -= playerVelocity.y_; }
+	if (playerEntity.getComponent<InputComponent>().down_) { movement.y_ += playerVelocity.y_; }
+	if (playerEntity.getComponent<InputComponent>().left_) { movement.x_ -= playerVelocity.x_; }
+	if (playerEntity.getComponent<InputComponent>().right_) { movement.x_ += playerVelocity.x_; }
+	playerEntity.getComponent<TransformComponent>().pos_ += movement;
+
+	// Pack enemies (which bounce off the walls) followed by bullets (which fly free)
+	// so both groups can be integrated by the batch kernels in one buffer.
+	ArenaVector<Entity> motionEntities{ArenaAllocator<Entity>{frameArena_}};
+	motionEntities.reserve(entities_.getEntities().size());
+	motionBuffer_.clear();
+	for (const auto tag : {EntityTag::Enemy, EntityTag::SmallEnemy})
 	{
-		if (entity->tag() == "player")
-		{
-			if (playerEntity->getComponent<InputComponent>().up_) { movement.y_ -= playerVelocity.y_; }
-			if (playerEntity->getComponent<InputComponent>().down_) { movement.y_ += playerVelocity.y_; }
-			if (playerEntity->getComponent<InputComponent>().left_) { movement.x_ -= playerVelocity.x_; }
-			if (playerEntity->getComponent<InputComponent>().right_) { movement.x_ += playerVelocity.x_; }
-			playerEntity->getComponent<TransformComponent>().pos_ += movement;
-		}
-		else if (entity->tag() == "enemy" || entity->tag() == "smallEnemy" || entity->tag() == "bullet")
+		for (const auto& entity : entities_.getEntities(tag)) { packMotion(motionEntities, entity); }
+	}
+	const size_t bouncing = motionBuffer_.size();
+	for (const auto& entity : entities_.getEntities(EntityTag::Bullet)) { packMotion(motionEntities, entity); }
+
+	const auto& windowConfig = gameConfig_.windowConfig_;
+	const float width = static_cast<float>(windowConfig.width_);
+	const float height = static_cast<float>(windowConfig.height_);
+	jobs_->parallelFor(motionEntities.size(), entityGrain, [&](const size_t begin, const size_t end)
+	{
+		// Split each range at the boundary between the bouncing and the free-flying group.
+		const size_t split = std::clamp(bouncing, begin, end);
+		MotionKernels::integrateAndBounce(motionBuffer_.batch(begin, split - begin), width, height);
+		MotionKernels::integrate(motionBuffer_.batch(split, end - split));
+
+		for (size_t i = begin; i < end; ++i)
 		{
-			entity->getComponent<TransformComponent>().pos_ += entity->getComponent<TransformComponent>().velocity_;
+			auto& transform = motionEntities[i].getComponent<TransformComponent>();
+			transform.pos_ = Vec2f{motionBuffer_.posX_[i], motionBuffer_.posY_[i]};
+			transform.velocity_ = Vec2f{motionBuffer_.velX_[i], motionBuffer_.velY_[i]};
 		}
-	}
+	});
+}
+
+void	Game::packMotion(ArenaVector<Entity>& motionEntities, const Entity& entity)
+{
+	const auto& transform = entity.getComponent<TransformComponent>();
+	motionEntities.push_back(entity);
+	motionBuffer_.push(transform.pos_.x_, transform.pos_.y_, transform.velocity_.x_, transform.velocity_.y_,
+						entity.getComponent<CollisionComponent>().radius_);
 }
 
 void	Game::collisionSystem()
 {
+	PROFILE_SCOPE(ProfileZone::Collision);
 	if (paused_) { return ; }
 
 	const auto& windowConfig = gameConfig_.windowConfig_;
 
-	auto& playerEntity = player();
-
 	auto& entities = entities_.getEntities();
-	for (auto& entity : entities)
+	collisionTargets_.clear();
+	for (uint32_t i = 0; i < entities.size(); ++i)
 	{
-		auto& pos = entity->getComponent<TransformComponent>().pos_;
-		auto& velocity = entity->getComponent<TransformComponent>().velocity_;
-		const auto collisionRadius = entity->getComponent<CollisionComponent>().radius_;
-		const auto& tag = entity->tag();
-		if (tag == "player")
+		const auto& entity = entities[i];
+		auto& pos = entity.getComponent<TransformComponent>().pos_;
+		const auto collisionRadius = entity.getComponent<CollisionComponent>().radius_;
+		const auto tag = entity.tag();
+		if (tag == EntityTag::Player)
 		{
 			if (pos.x_ - collisionRadius < 0.0f) { pos.x_ = collisionRadius; }
 			if (pos.x_ + collisionRadius > windowConfig.width_) { pos.x_ = windowConfig.width_ - collisionRadius; }
 			if (pos.y_ - collisionRadius < 0.0f) { pos.y_ = collisionRadius; }
 			if (pos.y_ + collisionRadius > windowConfig.height_) { pos.y_ = windowConfig.height_ - collisionRadius; }
 		}
-		else if (tag == "enemy" || tag == "smallEnemy")
+		else if (tag == EntityTag::Enemy || tag == EntityTag::SmallEnemy)
 		{
-			if (pos.x_ - collisionRadius < 0.0f || pos.x_ + collisionRadius > windowConfig.width_) { velocity.x_ *= -1; }
-			if (pos.y_ - collisionRadius < 0.0f || pos.y_ + collisionRadius > windowConfig.height_) { velocity.y_ *= -1; }
-			if (!imGuiConfig_.collision_) { continue ; }
-			if (playerEntity->getComponent<TransformComponent>().pos_.distSquared(pos) <
-				std::pow(playerEntity->getComponent<CollisionComponent>().radius_ + collisionRadius, 2))
-			{
-				const auto& playerConfig = gameConfig_.playerConfig_;
-				const auto& windowConfig = gameConfig_.windowConfig_;
-				Vec2f playerPos{windowConfig.width_ * playerConfig.pos_.x_, windowConfig.height_ * playerConfig.pos_.y_};
-				playerEntity->getComponent<TransformComponent>().pos_ = playerPos;
-				score_ = 0;
-				isSpecialWeaponAvailable_ = true;
-
-				entity->destroy();
-				if (tag == "enemy") { spawnSmallEnemies(entity); }
-			}
+			collisionTargets_.push_back(i);
 		}
 	}
 	if (!imGuiConfig_.collision_) { return ; }
-	auto& bullets = entities_.getEntities("bullet");
-	for (auto& bullet : bullets)
+
+	const bool useGrid = gameConfig_.collisionConfig_.spatialGrid_;
+	if (useGrid)
 	{
-		for (auto& entity : entities)
+		collisionGrid_.reset(static_cast<float>(windowConfig.width_), static_cast<float>(windowConfig.height_),
+								gameConfig_.collisionConfig_.cellSize_);
+		for (const auto index : collisionTargets_)
 		{
-			auto& pos = entity->getComponent<TransformComponent>().pos_;
-			auto& velocity = entity->getComponent<TransformComponent>().velocity_;
-			const auto collisionRadius = entity->getComponent<CollisionComponent>().radius_;
-			const auto& tag = entity->tag();
-			if (tag == "enemy" || tag == "smallEnemy")
+			const auto& entity = entities[index];
+			collisionGrid_.insert(index, entity.getComponent<TransformComponent>().pos_, entity.getComponent<CollisionComponent>().radius_);
+		}
+		collisionGrid_.build();
+	}
+
+	// Both broadphases hand out candidates in entity order, so they resolve hits identically.
+	// A hit moves the player to the spawn point, which invalidates the candidates, so the
+	// first hit ends the check; enemies at the spawn point are found next tick.
+	auto playerEntity = player();
+	const Vec2f playerPos = playerEntity.getComponent<TransformComponent>().pos_;
+	const float playerRadius = playerEntity.getComponent<CollisionComponent>().radius_;
+	for (const auto index : collisionCandidates(playerPos, playerRadius, useGrid, collisionCandidates_))
+	{
+		const auto& entity = entities[index];
+		const auto collisionRadius = entity.getComponent<CollisionComponent>().radius_;
+		if (!entity.isActive()) { continue ; }
+		if (playerPos.distSquared(entity.getComponent<TransformComponent>().pos_) <
+			(playerRadius + collisionRadius) * (playerRadius + collisionRadius))
+		{
+			const auto& playerConfig = gameConfig_.playerConfig_;
+			Vec2f spawnPos{windowConfig.width_ * playerConfig.pos_.x_, windowConfig.height_ * playerConfig.pos_.y_};
+			playerEntity.getComponent<TransformComponent>().pos_ = spawnPos;
+			playerEntity.getComponent<TransformComponent>().prevPos_ = spawnPos;
+			score_ = 0;
+			isSpecialWeaponAvailable_ = true;
+
+			entity.destroy();
+			if (entity.tag() == EntityTag::Enemy) { spawnSmallEnemies(entity); }
+			break ;
+		}
+	}
+
+	// Narrowphase in parallel: each chunk of bullets records its overlapping
+	// (bullet, target) pairs, then the hits are resolved serially in bullet order
+	// so the outcome does not depend on the worker count.
+	auto& bullets = entities_.getEntities(EntityTag::Bullet);
+	// Hit lists live in the frame arena, which workers may allocate from concurrently.
+	using HitList = ArenaVector<std::pair<uint32_t, uint32_t>>;
+	const size_t chunks = JobSystem::chunkCount(bullets.size(), bulletGrain);
+	ArenaVector<HitList> collisionHits{chunks, HitList{ArenaAllocator<HitList::value_type>{frameArena_}},
+												ArenaAllocator<HitList>{frameArena_}};
+	if (collisionScratch_.size() < chunks) { collisionScratch_.resize(chunks); }
+	jobs_->parallelFor(bullets.size(), bulletGrain, [&](const size_t begin, const size_t end)
+	{
+		auto& hits = collisionHits[begin / bulletGrain];
+		auto& scratch = collisionScratch_[begin / bulletGrain];
+		for (size_t i = begin; i < end; ++i)
+		{
+			const Vec2f bulletPos = bullets[i].getComponent<TransformComponent>().pos_;
+			const float bulletRadius = bullets[i].getComponent<CollisionComponent>().radius_;
+			for (const auto index : collisionCandidates(bulletPos, bulletRadius, useGrid, scratch))
 			{
-				if (bullet->getComponent<TransformComponent>().pos_.distSquared(entity->getComponent<TransformComponent>().pos_) <
-					std::pow(bullet->getComponent<CollisionComponent>().radius_ + entity->getComponent<CollisionComponent>().radius_, 2))
+				const auto collisionRadius = entities[index].getComponent<CollisionComponent>().radius_;
+				if (bulletPos.distSquared(entities[index].getComponent<TransformComponent>().pos_) <
+					(bulletRadius + collisionRadius) * (bulletRadius + collisionRadius))
 				{
-					bullet->destroy();
-					entity->destroy();
-					const auto vertices = entity->getComponent<ShapeComponent>().circle_.getPointCount();
-					if (tag == "enemy") { spawnSmallEnemies(entity); score_ += (vertices * 10); }
-					else { score_ += (static_cast<int>(vertices) * 20); }
-					score_ > highScore_ ? (highScore_ = score_) : void();
+					hits.emplace_back(static_cast<uint32_t>(i), index);
 				}
-			}	
+			}
+		}
+	});
+
+	for (size_t chunk = 0; chunk < chunks; ++chunk)
+	{
+		for (const auto& [bulletIndex, index] : collisionHits[chunk])
+		{
+			const auto& bullet = bullets[bulletIndex];
+			const auto& entity = entities[index];
+			if (!entity.isActive()) { continue ; }
+
+			bullet.destroy();
+			entity.destroy();
+			const auto& particleConfig = gameConfig_.particleConfig_;
+			const auto& shape = entity.getComponent<ShapeComponent>();
+			particles_.burst(entity.getComponent<TransformComponent>().pos_, particleConfig.sparks_, particleConfig.sparkSpeed_,
+								shape.fillColor_, particleConfig.sparkLifespan_);
+			const auto vertices = shape.pointCount_;
+			if (entity.tag() == EntityTag::Enemy) { spawnSmallEnemies(entity); score_ += (vertices * 10); }
+			else { score_ += (static_cast<int>(vertices) * 20); }
+			if (score_ > highScore_) { highScore_ = score_; }
 		}
 	}
 }
 
+const std::vector<uint32_t>&	Game::collisionCandidates(const Vec2f& pos, const float radius, const bool useGrid,
+															std::vector<uint32_t>& scratch) const
+{
+	if (!useGrid) { return (collisionTargets_); }
+
+	collisionGrid_.query(pos, radius, scratch);
+
+	return (scratch);
+}
+
 void	Game::lifespanSystem()
 {
+	PROFILE_SCOPE(ProfileZone::Lifespan);
 	if (paused_ || !imGuiConfig_.lifespan_) { return ; }
 
-	auto& entities = entities_.getEntities();
-	for (auto& entity : entities)
+	const LifespanView lifespans{entities_};
+	jobs_->parallelFor(lifespans.size(), entityGrain, [&lifespans](const size_t begin, const size_t end)
 	{
-		if (entity->hasComponent<LifespanComponent>())
+		lifespans.each(begin, end, [](const Entity& entity, LifespanComponent& entityLifespan, ShapeComponent& entityShape)
 		{
-			auto& entityLifespan = entity->getComponent<LifespanComponent>();
-			auto& entityShape = entity->getComponent<ShapeComponent>();
-
-			if (--entityLifespan.remaining_ < 1) { entity->destroy(); continue ; }
-			auto& entityColor = entityShape.circle_.getFillColor();
+			if (--entityLifespan.remaining_ < 1) { entity.destroy(); return ; }
 			auto alpha = static_cast<sf::Uint8>((entityLifespan.remaining_ / static_cast<float>(entityLifespan.lifespan_)) * 255.0f);
-			auto newColor = entityColor;
-			newColor.a = alpha;
-			entityShape.circle_.setFillColor(newColor);
-			entityShape.circle_.setOutlineColor(newColor);
+			entityShape.fillColor_.a = alpha;
+			entityShape.outlineColor_ = entityShape.fillColor_;
+		});
+	});
+}
+
+// Runs after the schedule on the main thread; collisionSystem emits the sparks.
+void	Game::particleSystem()
+{
+	PROFILE_SCOPE(ProfileZone::Particles);
+	if (paused_ || particles_.capacity() == 0) { return ; }
+
+	const auto& particleConfig = gameConfig_.particleConfig_;
+	if (imGuiConfig_.particles_ && particleConfig.trailInterval_ > 0 && currentFrame_ % particleConfig.trailInterval_ == 0)
+	{
+		for (const auto& bullet : entities_.getEntities(EntityTag::Bullet))
+		{
+			const auto& transform = bullet.getComponent<TransformComponent>();
+			Vec2f drift = transform.velocity_;
+			particles_.emit(transform.pos_, drift * -0.1f, bullet.getComponent<ShapeComponent>().fillColor_,
+							particleConfig.trailLifespan_);
 		}
 	}
+	particles_.update();
+}
+
+void	Game::publishRender(const RenderSnapshot::Clock::time_point now, const double accumulator)
+{
+	PROFILE_SCOPE(ProfileZone::Publish);
+	auto& frame = renderBuffer_.back();
+	frame.sequence_ = ++renderSequence_;
+	frame.tickSeconds_ = 1.0 / gameConfig_.simulationConfig_.tickRate_;
+	frame.tickTime_ = now - std::chrono::duration_cast<RenderSnapshot::Clock::duration>(std::chrono::duration<double>(accumulator));
+
+	frame.shapes_.clear();
+	if (imGuiConfig_.rendering_)
+	{
+		for (const auto& entity : entities_.getEntities())
+		{
+			const auto& transform = entity.getComponent<TransformComponent>();
+			frame.shapes_.push_back(RenderShape{transform.prevPos_, transform.pos_, transform.prevAngle_, transform.angle_,
+												entity.getComponent<ShapeComponent>()});
+		}
+	}
+	if (imGuiConfig_.rendering_ && imGuiConfig_.particles_) { particles_.collect(frame.particles_); }
+	else { frame.particles_.clear(); }
+
+	frame.score_ = score_;
+	frame.highScore_ = highScore_;
+	frame.specialWeaponReady_ = isSpecialWeaponAvailable_;
+	frame.paused_ = paused_;
+
+	auto& stats = frame.stats_;
+	stats.entities_ = entities_.getEntities().size();
+	for (size_t tag = 0; tag < entityTagCount; ++tag) { stats.tagCounts_[tag] = entities_.getEntities(static_cast<EntityTag>(tag)).size(); }
+	stats.particles_ = particles_.size();
+	stats.particleCapacity_ = particles_.capacity();
+	stats.particlesDropped_ = particles_.dropped();
+	stats.snapshotMicros_ = snapshotMicros_;
+	stats.snapshotAverageMicros_ = snapshotCount_ > 0 ? snapshotTotalMicros_ / snapshotCount_ : 0.0;
+	stats.snapshotBytes_ = snapshots_.size() > 0 ? snapshots_.back(0).size() : 0;
+	stats.ringSize_ = snapshots_.size();
+	stats.ringCapacity_ = snapshots_.capacity();
+	stats.ringBytes_ = snapshots_.bytes();
+	stats.canRestore_ = canRestore();
+	stats.inputThread_ = inputThread_ != nullptr;
+	stats.inputToSim_ = inputToSimLatency_.stats();
+	stats.inputsDropped_ = inputThread_ ? inputThread_->dropped() : 0;
+	stats.tickAllocations_ = tickAllocations_;
+	stats.poolBytes_ = entities_.getPool().bytes();
+	stats.poolSlots_ = entities_.getPool().capacity();
+	for (size_t tag = 0; tag < entityTagCount; ++tag)
+	{
+		stats.bucketBytes_[tag] = entities_.getEntities(static_cast<EntityTag>(tag)).capacity() * sizeof(Entity);
+	}
+	stats.arenaPeak_ = frameArena_.peak();
+	stats.arenaCapacity_ = frameArena_.capacity();
+
+	renderBuffer_.publish();
+}
+
+void	Game::applyGuiChanges()
+{
+	GuiSettings settings;
+	GuiCommands commands;
+	{
+		const std::lock_guard<std::mutex> lock{guiMutex_};
+		if (!guiMailboxFresh_) { return ; }
+
+		settings = guiMailboxSettings_;
+		commands = std::exchange(guiMailboxCommands_, GuiCommands{});
+		guiMailboxFresh_ = false;
+	}
+
+	imGuiConfig_ = settings.config_;
+	gameConfig_.collisionConfig_.spatialGrid_ = settings.spatialGrid_;
+	gameConfig_.enemyConfig_.spawnInterval_ = settings.spawnInterval_;
+	for (int i = 0; i < commands.manualSpawns_; ++i) { spawnEnemy(); }
+	if (commands.rewindAge_ >= 0) { rewind(static_cast<size_t>(commands.rewindAge_)); }
+	if (commands.saveState_) { saveStateFile(stateFilePath); }
+	if (commands.loadState_) { loadStateFile(stateFilePath); }
+}
+
+void	Game::renderLoop()
+{
+	Profiler::setThreadName("render");
+	window_.setActive(true);
+	while (!renderStopping_.load(std::memory_order_relaxed)) { renderFrame(); }
+	window_.setActive(false);
+}
+
+// Everything from here down runs on the render thread (or after the ticks when
+// simulation.renderThread is off) and only sees the newest RenderSnapshot.
+void	Game::renderFrame()
+{
+	renderBuffer_.acquire();
+	const RenderSnapshot& frame = renderBuffer_.front();
+
+	{
+		const MemoryScope scope{MemoryTag::ImGui};
+		sf::Event event;
+		while (windowEvents_.pop(event)) { ImGui::SFML::ProcessEvent(window_, event); }
+		ImGui::SFML::Update(window_, deltaClock_.restart());
+		GUISystem(frame.stats_);
+	}
+	guiWantsMouse_.store(ImGui::GetIO().WantCaptureMouse, std::memory_order_relaxed);
+	{
+		const std::lock_guard<std::mutex> lock{guiMutex_};
+		guiMailboxSettings_ = guiSettings_;
+		guiMailboxCommands_.manualSpawns_ += guiCommands_.manualSpawns_;
+		if (guiCommands_.rewindAge_ >= 0) { guiMailboxCommands_.rewindAge_ = guiCommands_.rewindAge_; }
+		guiMailboxCommands_.saveState_ |= guiCommands_.saveState_;
+		guiMailboxCommands_.loadState_ |= guiCommands_.loadState_;
+		guiMailboxFresh_ = true;
+	}
+	guiCommands_ = GuiCommands{};
+
+	const double sinceTick = std::chrono::duration<double>(RenderSnapshot::Clock::now() - frame.tickTime_).count();
+	renderSystem(frame, static_cast<float>(std::clamp(sinceTick / frame.tickSeconds_, 0.0, 1.0)));
 }
 
-void	Game::GUISystem()
+void	Game::GUISystem(const GuiStats& stats)
 {
+	PROFILE_SCOPE(ProfileZone::GUI);
+	auto& config = guiSettings_.config_;
 	ImGui::Begin("Geometry Wars");
 	if (ImGui::BeginTabBar("MyTabBar"))
 	{
 		if (ImGui::BeginTabItem("Systems"))
 		{
-			ImGui::Checkbox("Movement", &imGuiConfig_.movement_);
-			ImGui::Checkbox("Lifespan", &imGuiConfig_.lifespan_);
-			ImGui::Checkbox("Collision", &imGuiConfig_.collision_);
-			ImGui::Checkbox("Spawning", &imGuiConfig_.spawning_);
-			if (imGuiConfig_.spawning_)
+			ImGui::Checkbox("Movement", &config.movement_);
+			ImGui::Checkbox("Lifespan", &config.lifespan_);
+			ImGui::Checkbox("Collision", &config.collision_);
+			if (config.collision_)
+			{
+				ImGui::Indent(30);
+				ImGui::Checkbox("Spatial Grid", &guiSettings_.spatialGrid_);
+				ImGui::Unindent(30);
+			}
+			ImGui::Checkbox("Spawning", &config.spawning_);
+			if (config.spawning_)
 			{
 				ImGui::Indent(30);
-				ImGui::SliderInt("Spawn", &gameConfig_.enemyConfig_.spawnInterval_, 0, 180);
+				ImGui::SliderInt("Spawn", &guiSettings_.spawnInterval_, 0, 180);
 				if (ImGui::Button("Manual Spawn"))
 				{
-					spawnEnemy();
+					++guiCommands_.manualSpawns_;
 				}
 				ImGui::Unindent(30);
 			}
-			ImGui::Checkbox("Rendering", &imGuiConfig_.rendering_);
+			ImGui::Checkbox("Particles", &config.particles_);
+			ImGui::Checkbox("Rendering", &config.rendering_);
+			ImGui::EndTabItem();
+		}
+		if (ImGui::BeginTabItem("Profiler"))
+		{
+			profilerTab(stats);
+			ImGui::EndTabItem();
+		}
+		if (ImGui::BeginTabItem("Snapshots"))
+		{
+			snapshotTab(stats);
+			ImGui::EndTabItem();
+		}
+		if (ImGui::BeginTabItem("Memory"))
+		{
+			memoryTab(stats);
 			ImGui::EndTabItem();
 		}
 		ImGui::EndTabBar();
@@ -385,35 +1156,159 @@ void	Game::GUISystem()
 	ImGui::End();
 }
 
-void	Game::renderSystem()
+void	Game::profilerTab(const GuiStats& stats)
 {
+	ImGui::Text("Entities: %zu", stats.entities_);
+	for (size_t tag = 0; tag < entityTagCount; ++tag)
+	{
+		ImGui::SameLine();
+		ImGui::Text("%s %zu", entityTagNames[tag], stats.tagCounts_[tag]);
+	}
+	ImGui::Text("Particles: %zu / %zu, %zu dropped", stats.particles_, stats.particleCapacity_, stats.particlesDropped_);
+	if (stats.inputThread_)
+	{
+		const auto& sim = stats.inputToSim_;
+		const auto present = inputToPresentLatency_.stats();
+		ImGui::Text("%-16s p50 %6.3f  p99 %6.3f  max %6.3f ms", "input->sim", sim.p50_, sim.p99_, sim.max_);
+		ImGui::Text("%-16s p50 %6.3f  p99 %6.3f  max %6.3f ms", "input->present", present.p50_, present.p99_, present.max_);
+		if (stats.inputsDropped_ > 0) { ImGui::Text("%zu input events dropped", stats.inputsDropped_); }
+	}
+	ImGui::Separator();
+
+	if constexpr (!Profiler::enabled)
+	{
+		ImGui::TextUnformatted("Built without GEOMETRY_WARS_PROFILER.");
+		return ;
+	}
+
+	ImGui::Text("Last %zu frames, F9 writes trace.json", Profiler::historySize);
+	for (size_t zone = 0; zone <= profileZoneCount; ++zone)
+	{
+		const auto profileZone = static_cast<ProfileZone>(zone);
+		const char* name = zone == profileZoneCount ? "frame" : profileZoneNames[zone];
+		const auto zoneStats = Profiler::stats(profileZone);
+		Profiler::history(profileZone, profilerSamples_);
+
+		ImGui::Text("%-12s p50 %6.3f  p99 %6.3f  max %6.3f ms", name, zoneStats.p50_, zoneStats.p99_, zoneStats.max_);
+		ImGui::PlotLines(name, profilerSamples_.data(), static_cast<int>(profilerSamples_.size()), 0, nullptr,
+							0.0f, std::max(zoneStats.max_, 0.001f), ImVec2(0, 40));
+	}
+}
+
+void	Game::snapshotTab(const GuiStats& stats)
+{
+	const auto& simulationConfig = gameConfig_.simulationConfig_;
+	ImGui::Text("Last snapshot %.1f us, %zu bytes (avg %.1f us)", stats.snapshotMicros_, stats.snapshotBytes_,
+				stats.snapshotAverageMicros_);
+	ImGui::Text("Ring %zu / %zu snapshots, %.1f MB", stats.ringSize_, stats.ringCapacity_, stats.ringBytes_ / (1024.0 * 1024.0));
+	ImGui::Separator();
+
+	if (!stats.canRestore_)
+	{
+		ImGui::TextUnformatted("Rewind and load are disabled while recording or replaying.");
+	}
+	else if (stats.ringSize_ > 1)
+	{
+		const int maxAge = static_cast<int>(stats.ringSize_) - 1;
+		rewindAge_ = std::min(rewindAge_, maxAge);
+		ImGui::SliderInt("Snapshots back", &rewindAge_, 0, maxAge);
+		ImGui::SameLine();
+		ImGui::Text("%.2f s", rewindAge_ * simulationConfig.snapshotInterval_ / static_cast<float>(simulationConfig.tickRate_));
+		if (ImGui::Button("Rewind"))
+		{
+			guiCommands_.rewindAge_ = rewindAge_;
+			rewindAge_ = 0;
+		}
+	}
+
+	if (ImGui::Button("Save State (F5)")) { guiCommands_.saveState_ = true; }
+	ImGui::SameLine();
+	if (ImGui::Button("Load State (F6)")) { guiCommands_.loadState_ = true; }
+}
+
+void	Game::memoryTab(const GuiStats& stats)
+{
+	constexpr double kib = 1024.0;
+	const auto& scenarioConfig = gameConfig_.scenarioConfig_;
+	ImGui::Text("Allocations last tick: %llu", static_cast<unsigned long long>(stats.tickAllocations_));
+	ImGui::Text("Entity pool: %.1f KiB for %zu slots (%.0f bytes per entity)", stats.poolBytes_ / kib, stats.poolSlots_,
+				stats.poolSlots_ > 0 ? static_cast<double>(stats.poolBytes_) / stats.poolSlots_ : 0.0);
+	for (size_t tag = 0; tag < entityTagCount; ++tag)
+	{
+		ImGui::Text("  %-12s bucket %.1f KiB", entityTagNames[tag], stats.bucketBytes_[tag] / kib);
+	}
+	ImGui::Text("Frame arena: peak %.1f KiB of %.1f KiB", stats.arenaPeak_ / kib, stats.arenaCapacity_ / kib);
+	ImGui::Separator();
+
+	if constexpr (!AllocationCounter::tracking)
+	{
+		ImGui::TextUnformatted("Built without GEOMETRY_WARS_TRACK_MEMORY, live bytes are not tracked.");
+		return ;
+	}
+
+	ImGui::Text("%-10s %12s %12s %12s %12s", "tag", "allocations", "live KiB", "peak KiB", "budget KiB");
+	for (size_t tag = 0; tag <= memoryTagCount; ++tag)
+	{
+		const bool total = tag == memoryTagCount;
+		const auto memory = total ? AllocationCounter::total() : AllocationCounter::stats(static_cast<MemoryTag>(tag));
+		const size_t budget = total ? scenarioConfig.memoryBudgetTotal_ : scenarioConfig.memoryBudgets_[tag];
+		const ImVec4 color = budget > 0 && memory.peakBytes_ > budget ? ImVec4{1.0f, 0.3f, 0.3f, 1.0f} : ImGui::GetStyleColorVec4(ImGuiCol_Text);
+		ImGui::TextColored(color, "%-10s %12llu %12.1f %12.1f %12.1f", total ? "total" : memoryTagNames[tag],
+							static_cast<unsigned long long>(memory.allocations_), memory.liveBytes_ / kib, memory.peakBytes_ / kib, budget / kib);
+	}
+}
+
+void	Game::renderSystem(const RenderSnapshot& frame, const float alpha)
+{
+	PROFILE_SCOPE(ProfileZone::Render);
+	const MemoryScope scope{MemoryTag::Sfml};
 	window_.clear();
 
-	if (imGuiConfig_.rendering_)
+	if (guiSettings_.config_.rendering_)
 	{
-		auto entities = entities_.getEntities();
-		for (auto& entity : entities)
+		shapeRenderer_.clear();
+		for (const auto& shape : frame.shapes_)
 		{
-			entity->getComponent<ShapeComponent>().circle_.setRotation(entity->getComponent<TransformComponent>().angle_);
-			entity->getComponent<ShapeComponent>().circle_.setPosition(entity->getComponent<TransformComponent>().pos_);
-			window_.draw(entity->getComponent<ShapeComponent>().circle_);
+			// Draw between the last two ticks so motion stays smooth when the render rate differs from the tick rate.
+			const Vec2f pos = shape.prevPos_ + (shape.pos_ - shape.prevPos_) * alpha;
+			const float angle = shape.prevAngle_ + (shape.angle_ - shape.prevAngle_) * alpha;
+			shapeRenderer_.add(pos, angle, shape.shape_);
 		}
-		scoreText_.setString("SCORE: " + std::to_string(score_));
-		highScoreText_.setString("HIGH SCORE: " + std::to_string(highScore_));
-		window_.draw(scoreText_);
-		window_.draw(highScoreText_);
-		isSpecialWeaponAvailable_ ? specialWeaponText_.setString(specialWeaponAvailable_) : specialWeaponText_.setString(specialWeaponCooldown_);
-		window_.draw(specialWeaponText_);
-		if (paused_) { window_.draw(pauseText_); }
+		const float streak = gameConfig_.particleConfig_.streak_;
+		for (const auto& particle : frame.particles_)
+		{
+			Vec2f velocity = particle.velocity_;
+			const Vec2f head = particle.pos_ - velocity * (1.0f - alpha);
+			shapeRenderer_.addStreak(head, head - velocity * streak, particle.color_, particleWidth);
+		}
+		shapeRenderer_.draw(window_);
+		hud_.setScore(frame.score_);
+		hud_.setHighScore(frame.highScore_);
+		hud_.setSpecialWeaponReady(frame.specialWeaponReady_);
+		hud_.draw(window_, frame.paused_);
 	}
 
-	ImGui::SFML::Render(window_);
+	{
+		const MemoryScope imguiScope{MemoryTag::ImGui};
+		ImGui::SFML::Render(window_);
+	}
 	window_.display();
+
+	const auto presented = InputEvent::Clock::now();
+	PendingInput input;
+	while (inputsToPresent_.pop(input)) { waitingInputs_.push_back(input); }
+	auto waiting = waitingInputs_.begin();
+	for (const auto& pending : waitingInputs_)
+	{
+		if (pending.sequence_ <= frame.sequence_) { inputToPresentLatency_.add(pending.time_, presented); }
+		else { *waiting++ = pending; }
+	}
+	waitingInputs_.erase(waiting, waitingInputs_.end());
 }
 
-std::shared_ptr<Entity>	Game::player()
+Entity	Game::player()
 {
-	auto& players = entities_.getEntities("player");
+	auto& players = entities_.getEntities(EntityTag::Player);
 
 	if (players.size() != 1)
 	{
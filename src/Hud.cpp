@@ -0,0 +1,83 @@
+#include "Hud.h"
+
+#include <charconv>
+
+namespace
+{
+	const std::string	specialWeaponReady = "Special Weapon Ready!";
+	const std::string	specialWeaponCooldown = "Cooldown in Progress...";
+	const std::string	paused = "PAUSED";
+}
+
+void	Hud::requestFonts(ResourceCache& resources, const UIConfig& uiConfig)
+{
+	scoreFont_ = resources.requestFont(uiConfig.score_.path_);
+	highScoreFont_ = resources.requestFont(uiConfig.highScore_.path_);
+	specialWeaponFont_ = resources.requestFont(uiConfig.specialWeapon_.path_);
+	pauseFont_ = resources.requestFont(uiConfig.pause_.path_);
+}
+
+void	Hud::init(const ResourceCache& resources, const GameConfig& gameConfig)
+{
+	const auto& uiConfig = gameConfig.uiConfig_;
+	windowSize_ = Vec2f{static_cast<float>(gameConfig.windowConfig_.width_), static_cast<float>(gameConfig.windowConfig_.height_)};
+
+	initCounter(score_, resources.font(scoreFont_), uiConfig.score_, "SCORE: ");
+	initCounter(highScore_, resources.font(highScoreFont_), uiConfig.highScore_, "HIGH SCORE: ");
+	setScore(0);
+	setHighScore(0);
+
+	// Both special weapon texts sit where the ready text is centered, as they always have.
+	initText(specialWeaponReadyText_, resources.font(specialWeaponFont_), uiConfig.specialWeapon_, specialWeaponReady);
+	specialWeaponCooldownText_ = specialWeaponReadyText_;
+	specialWeaponCooldownText_.setString(specialWeaponCooldown);
+	initText(pauseText_, resources.font(pauseFont_), uiConfig.pause_, paused);
+
+	labels_.create(gameConfig.windowConfig_.width_, gameConfig.windowConfig_.height_);
+	labels_.clear(sf::Color::Transparent);
+	labels_.draw(score_.label_);
+	labels_.draw(highScore_.label_);
+	labels_.display();
+	labelSprite_.setTexture(labels_.getTexture());
+}
+
+void	Hud::initText(sf::Text& text, const sf::Font& font, const Font& fontConfig, const std::string& str) const
+{
+	text.setFont(font);
+	text.setString(str);
+	text.setCharacterSize(fontConfig.size_);
+	text.setFillColor(fontConfig.color_);
+	text.setPosition(sf::Vector2f{windowSize_.x_ * fontConfig.pos_.x_ - text.getGlobalBounds().width / 2.0f,
+									windowSize_.y_ * fontConfig.pos_.y_ - text.getCharacterSize() / 2.0f});
+}
+
+// The counter is anchored like an empty text; the value starts where the label ends.
+void	Hud::initCounter(Counter& counter, const sf::Font& font, const Font& fontConfig, const std::string& label) const
+{
+	initText(counter.label_, font, fontConfig, "");
+	counter.label_.setString(label);
+	initText(counter.value_, font, fontConfig, "");
+	counter.value_.setPosition(counter.label_.findCharacterPos(label.size()));
+}
+
+void	Hud::setValue(Counter& counter, const size_t value)
+{
+	if (counter.valid_ && counter.shown_ == value) { return ; }
+
+	char digits[24];
+	const auto result = std::to_chars(digits, digits + sizeof(digits) - 1, value);
+	*result.ptr = '\0';
+	counter.value_.setString(digits);
+	counter.shown_ = value;
+	counter.valid_ = true;
+}
+
+void	Hud::draw(sf::RenderTarget& target, const bool paused) const
+{
+	// The label texture holds premultiplied colors (text blended onto transparent black).
+	target.draw(labelSprite_, sf::RenderStates{sf::BlendMode{sf::BlendMode::One, sf::BlendMode::OneMinusSrcAlpha}});
+	target.draw(score_.value_);
+	target.draw(highScore_.value_);
+	target.draw(specialWeaponReady_ ? specialWeaponReadyText_ : specialWeaponCooldownText_);
+	if (paused) { target.draw(pauseText_); }
+}
@@ -0,0 +1,202 @@
+#include "InputRecording.h"
+
+#include <spdlog/spdlog.h>
+#include <iterator>
+
+namespace
+{
+	constexpr char		magic[4] = {'G', 'W', 'I', 'R'};
+	constexpr uint32_t	version = 2;
+
+	enum Button : uint8_t
+	{
+		Up = 1 << 0,
+		Down = 1 << 1,
+		Left = 1 << 2,
+		Right = 1 << 3
+	};
+
+	template<typename T>
+	void	writeValue(std::ofstream& out, const T value)
+	{
+		char bytes[sizeof(T)];
+		for (size_t i = 0; i < sizeof(T); ++i) { bytes[i] = static_cast<char>((static_cast<uint64_t>(value) >> (8 * i)) & 0xff); }
+		out.write(bytes, sizeof(T));
+	}
+
+	class Reader
+	{
+		public:
+			Reader(const std::vector<char>& data, const std::string& path) :
+				data_{data}, path_{path} {}
+
+			template<typename T>
+			T		read()
+			{
+				if (offset_ + sizeof(T) > data_.size())
+				{
+					SPDLOG_ERROR("Truncated input recording: {}", path_);
+					exit(1);
+				}
+				uint64_t value = 0;
+				for (size_t i = 0; i < sizeof(T); ++i) { value |= static_cast<uint64_t>(static_cast<uint8_t>(data_[offset_ + i])) << (8 * i); }
+				offset_ += sizeof(T);
+
+				return (static_cast<T>(value));
+			}
+
+			bool	done() const { return (offset_ >= data_.size()); }
+
+		private:
+			const std::vector<char>&	data_;
+			const std::string&			path_;
+			size_t						offset_ = 0;
+	};
+}
+
+uint8_t	InputFrame::buttons() const
+{
+	return (static_cast<uint8_t>((up_ ? Up : 0) | (down_ ? Down : 0) | (left_ ? Left : 0) | (right_ ? Right : 0)));
+}
+
+void	InputFrame::setButtons(const uint8_t buttons)
+{
+	up_ = buttons & Up;
+	down_ = buttons & Down;
+	left_ = buttons & Left;
+	right_ = buttons & Right;
+}
+
+InputRecorder::InputRecorder(const std::string& path, const RecordingHeader& header) :
+	out_{path, std::ios::binary}, path_{path}
+{
+	if (!out_)
+	{
+		SPDLOG_ERROR("Failed to open input recording for writing: {}", path);
+		exit(1);
+	}
+
+	out_.write(magic, sizeof(magic));
+	writeValue<uint32_t>(out_, version);
+	writeValue<uint64_t>(out_, header.seed_);
+	writeValue<uint64_t>(out_, header.configHash_);
+	writeValue<uint32_t>(out_, header.tickRate_);
+}
+
+InputRecorder::~InputRecorder()
+{
+	close();
+}
+
+void	InputRecorder::write(const InputFrame& frame)
+{
+	++ticks_;
+	if (runLength_ > 0 && runLength_ < UINT16_MAX && frame.actions_.empty() && frame.buttons() == current_.buttons())
+	{
+		++runLength_;
+		return ;
+	}
+
+	flushRecord();
+	current_ = frame;
+	runLength_ = 1;
+}
+
+void	InputRecorder::close()
+{
+	if (!out_.is_open()) { return ; }
+
+	flushRecord();
+	out_.close();
+	SPDLOG_INFO("Recorded {} ticks of input to {}", ticks_, path_);
+}
+
+void	InputRecorder::flushRecord()
+{
+	if (runLength_ == 0) { return ; }
+
+	writeValue<uint16_t>(out_, runLength_);
+	writeValue<uint8_t>(out_, current_.buttons());
+	// Dropping actions would make the replay diverge, so an oversized tick ends the recording instead.
+	if (current_.actions_.size() > UINT16_MAX)
+	{
+		SPDLOG_ERROR("{} input actions in one tick do not fit in the recording: {}", current_.actions_.size(), path_);
+		exit(1);
+	}
+	writeValue<uint16_t>(out_, static_cast<uint16_t>(current_.actions_.size()));
+	for (const auto& action : current_.actions_)
+	{
+		writeValue<uint8_t>(out_, action.type_);
+		writeValue<int32_t>(out_, action.target_.x_);
+		writeValue<int32_t>(out_, action.target_.y_);
+	}
+	runLength_ = 0;
+}
+
+InputReplay::InputReplay(const std::string& path)
+{
+	std::ifstream in{path, std::ios::binary};
+	if (!in)
+	{
+		SPDLOG_ERROR("Failed to open input recording: {}", path);
+		exit(1);
+	}
+	const std::vector<char> data{std::istreambuf_iterator<char>{in}, std::istreambuf_iterator<char>{}};
+
+	Reader reader{data, path};
+	for (const char c : magic)
+	{
+		if (reader.read<char>() != c)
+		{
+			SPDLOG_ERROR("Not an input recording: {}", path);
+			exit(1);
+		}
+	}
+	const uint32_t fileVersion = reader.read<uint32_t>();
+	if (fileVersion != version)
+	{
+		SPDLOG_ERROR("Unsupported input recording version {} (expected {}): {}", fileVersion, version, path);
+		exit(1);
+	}
+	header_.seed_ = reader.read<uint64_t>();
+	header_.configHash_ = reader.read<uint64_t>();
+	header_.tickRate_ = reader.read<uint32_t>();
+
+	while (!reader.done())
+	{
+		Record record;
+		record.runLength_ = reader.read<uint16_t>();
+		record.frame_.setButtons(reader.read<uint8_t>());
+		const uint16_t actionCount = reader.read<uint16_t>();
+		for (uint16_t i = 0; i < actionCount; ++i)
+		{
+			InputAction action;
+			action.type_ = static_cast<InputAction::Type>(reader.read<uint8_t>());
+			action.target_.x_ = reader.read<int32_t>();
+			action.target_.y_ = reader.read<int32_t>();
+			record.frame_.actions_.push_back(action);
+		}
+		ticks_ += record.runLength_;
+		records_.push_back(std::move(record));
+	}
+}
+
+void	InputReplay::next(InputFrame& frame)
+{
+	frame.actions_.clear();
+	if (finished())
+	{
+		frame.setButtons(0);
+		return ;
+	}
+
+	const Record& record = records_[cursor_];
+	frame.setButtons(record.frame_.buttons());
+	if (consumed_ == 0) { frame.actions_ = record.frame_.actions_; }
+
+	if (++consumed_ >= record.runLength_)
+	{
+		++cursor_;
+		consumed_ = 0;
+	}
+}
@@ -0,0 +1,93 @@
+#include "InputThread.h"
+
+# include <algorithm>
+
+namespace
+{
+	constexpr size_t	queueCapacity = 1024;
+
+	uint8_t	sampleButtons()
+	{
+		InputFrame frame;
+		frame.up_ = sf::Keyboard::isKeyPressed(sf::Keyboard::W);
+		frame.down_ = sf::Keyboard::isKeyPressed(sf::Keyboard::S);
+		frame.left_ = sf::Keyboard::isKeyPressed(sf::Keyboard::A);
+		frame.right_ = sf::Keyboard::isKeyPressed(sf::Keyboard::D);
+
+		return (frame.buttons());
+	}
+}
+
+InputThread::InputThread(const sf::Window& window, const int pollHz) :
+	window_{window}, interval_{std::chrono::nanoseconds{1000000000 / std::max(1, pollHz)}}, queue_{queueCapacity}
+{
+	thread_ = std::thread{[this] { run(); }};
+}
+
+InputThread::~InputThread()
+{
+	stopping_.store(true, std::memory_order_relaxed);
+	thread_.join();
+}
+
+void	InputThread::push(const InputEvent& event)
+{
+	if (!queue_.push(event)) { dropped_.fetch_add(1, std::memory_order_relaxed); }
+}
+
+// Only edges are sent: a button change, or a key/mouse press that was up on the previous sample.
+void	InputThread::run()
+{
+	Profiler::setThreadName("input");
+	uint8_t buttons = 0;
+	bool pause = false;
+	bool left = false;
+	bool right = false;
+	auto next = InputEvent::Clock::now();
+	while (!stopping_.load(std::memory_order_relaxed))
+	{
+		next += interval_;
+		std::this_thread::sleep_until(next);
+
+		const auto now = InputEvent::Clock::now();
+		const bool focused = focused_.load(std::memory_order_relaxed);
+		const uint8_t currentButtons = focused ? sampleButtons() : 0;
+		if (currentButtons != buttons)
+		{
+			buttons = currentButtons;
+			push(InputEvent{InputEvent::Buttons, buttons, InputAction{}, now});
+		}
+
+		const bool currentPause = focused && sf::Keyboard::isKeyPressed(sf::Keyboard::P);
+		const bool currentLeft = focused && sf::Mouse::isButtonPressed(sf::Mouse::Left);
+		const bool currentRight = focused && sf::Mouse::isButtonPressed(sf::Mouse::Right);
+		if ((currentLeft && !left) || (currentRight && !right))
+		{
+			const sf::Vector2i mouse = sf::Mouse::getPosition(window_);
+			const Vec2i target{mouse.x, mouse.y};
+			if (currentLeft && !left) { push(InputEvent{InputEvent::Action, 0, InputAction{InputAction::Shoot, target}, now}); }
+			if (currentRight && !right) { push(InputEvent{InputEvent::Action, 0, InputAction{InputAction::SpecialWeapon, target}, now}); }
+		}
+		if (currentPause && !pause) { push(InputEvent{InputEvent::Action, 0, InputAction{InputAction::TogglePause, Vec2i{}}, now}); }
+		pause = currentPause;
+		left = currentLeft;
+		right = currentRight;
+
+		// Fell behind (e.g. the machine was suspended): resynchronize instead of spinning to catch up.
+		if (now - next > interval_ * 4) { next = now; }
+	}
+}
+
+void	LatencyStats::add(const InputEvent::Clock::time_point from, const InputEvent::Clock::time_point to)
+{
+	samples_[next_] = std::chrono::duration<float, std::milli>(to - from).count();
+	next_ = (next_ + 1) % historySize;
+	count_ = std::min(count_ + 1, historySize);
+}
+
+ProfileStats	LatencyStats::stats() const
+{
+	std::vector<float> samples{samples_, samples_ + count_};
+
+	return (Profiler::stats(samples));
+}
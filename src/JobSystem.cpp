@@ -0,0 +1,166 @@
+#include "JobSystem.h"
+#include "Profiler.h"
+
+# include <algorithm>
+
+namespace
+{
+	thread_local size_t	threadIndex = 0;
+}
+
+JobSystem::JobSystem(const size_t threadCount)
+{
+	size_t count = threadCount;
+	if (count == 0) { count = std::max<size_t>(1, std::thread::hardware_concurrency()); }
+
+	for (size_t i = 0; i < count; ++i) { queues_.push_back(std::make_unique<WorkQueue>()); }
+	for (size_t i = 1; i < count; ++i) { workers_.emplace_back(&JobSystem::workerLoop, this, i); }
+}
+
+JobSystem::~JobSystem()
+{
+	{
+		std::lock_guard<std::mutex> lock{sleepMutex_};
+		stopping_ = true;
+	}
+	wake_.notify_all();
+
+	for (auto& worker : workers_) { worker.join(); }
+}
+
+void	JobSystem::parallelFor(const size_t count, const size_t grain, const RangeFn& body)
+{
+	if (count == 0) { return ; }
+
+	const size_t step = std::max<size_t>(1, grain);
+	const size_t chunks = chunkCount(count, step);
+	if (workers_.empty() || chunks == 1)
+	{
+		for (size_t begin = 0; begin < count; begin += step) { body(begin, std::min(count, begin + step)); }
+		return ;
+	}
+
+	const size_t index = currentThreadIndex() < queues_.size() ? currentThreadIndex() : 0;
+	const MemoryTag tag = AllocationCounter::currentTag();
+	std::atomic<size_t> pending{chunks};
+	{
+		auto& queue = *queues_[index];
+		std::lock_guard<std::mutex> lock{queue.mutex_};
+		// Pushed back to front so the owner pops chunks in ascending order.
+		for (size_t chunk = chunks; chunk-- > 0;)
+		{
+			const size_t begin = chunk * step;
+			queue.pushBack(Job{&body, begin, std::min(count, begin + step), &pending, tag});
+		}
+	}
+	queued_ += chunks;
+	{
+		std::lock_guard<std::mutex> lock{sleepMutex_};
+	}
+	wake_.notify_all();
+
+	while (pending.load(std::memory_order_acquire) > 0)
+	{
+		if (!tryRunOne(index)) { std::this_thread::yield(); }
+	}
+}
+
+void	JobSystem::parallelInvoke(const std::vector<std::function<void()>>& tasks)
+{
+	parallelFor(tasks.size(), 1, [&tasks](const size_t begin, const size_t end)
+	{
+		for (size_t i = begin; i < end; ++i) { tasks[i](); }
+	});
+}
+
+size_t	JobSystem::currentThreadIndex() { return (threadIndex); }
+
+void	JobSystem::workerLoop(const size_t index)
+{
+	threadIndex = index;
+	Profiler::setThreadName("worker " + std::to_string(index));
+
+	while (true)
+	{
+		if (tryRunOne(index)) { continue ; }
+
+		std::unique_lock<std::mutex> lock{sleepMutex_};
+		wake_.wait(lock, [this] { return (stopping_ || queued_.load() > 0); });
+		if (stopping_) { return ; }
+	}
+}
+
+bool	JobSystem::tryRunOne(const size_t index)
+{
+	Job job;
+	if (!popLocal(index, job) && !steal(index, job)) { return (false); }
+
+	execute(job);
+
+	return (true);
+}
+
+bool	JobSystem::popLocal(const size_t index, Job& job)
+{
+	auto& queue = *queues_[index];
+	std::lock_guard<std::mutex> lock{queue.mutex_};
+	if (queue.size_ == 0) { return (false); }
+
+	job = queue.popBack();
+	--queued_;
+
+	return (true);
+}
+
+bool	JobSystem::steal(const size_t index, Job& job)
+{
+	for (size_t offset = 1; offset < queues_.size(); ++offset)
+	{
+		auto& queue = *queues_[(index + offset) % queues_.size()];
+		std::lock_guard<std::mutex> lock{queue.mutex_};
+		if (queue.size_ == 0) { continue ; }
+
+		job = queue.popFront();
+		--queued_;
+
+		return (true);
+	}
+
+	return (false);
+}
+
+void	JobSystem::WorkQueue::pushBack(const Job& job)
+{
+	if (size_ == jobs_.size())
+	{
+		std::vector<Job> grown(std::max<size_t>(64, jobs_.size() * 2));
+		for (size_t i = 0; i < size_; ++i) { grown[i] = jobs_[(head_ + i) % jobs_.size()]; }
+		jobs_.swap(grown);
+		head_ = 0;
+	}
+	jobs_[(head_ + size_) % jobs_.size()] = job;
+	++size_;
+}
+
+JobSystem::Job	JobSystem::WorkQueue::popBack()
+{
+	--size_;
+
+	return (jobs_[(head_ + size_) % jobs_.size()]);
+}
+
+JobSystem::Job	JobSystem::WorkQueue::popFront()
+{
+	const Job job = jobs_[head_];
+	head_ = (head_ + 1) % jobs_.size();
+	--size_;
+
+	return (job);
+}
+
+void	JobSystem::execute(const Job& job)
+{
+	const MemoryScope scope{job.tag_};
+	(*job.body_)(job.begin_, job.end_);
+	job.pending_->fetch_sub(1, std::memory_order_release);
+}
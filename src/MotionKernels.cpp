@@ -0,0 +1,208 @@
+#include "MotionKernels.h"
+
+// x86-64 only: SSE2 is part of its baseline, so the SSE2 kernels need neither a
+// target attribute nor a CPUID check. 32-bit x86 builds use the scalar kernels.
+#if defined(__x86_64__) || defined(_M_X64)
+# define GW_X86 1
+# include <immintrin.h>
+# if defined(_MSC_VER) && !defined(__clang__)
+#  include <intrin.h>
+#  define GW_TARGET_AVX2
+# else
+#  define GW_TARGET_AVX2 __attribute__((target("avx2")))
+# endif
+#else
+# define GW_X86 0
+#endif
+
+namespace
+{
+	void	integrateScalar(const MotionBatch& batch)
+	{
+		for (size_t i = 0; i < batch.count_; ++i)
+		{
+			batch.posX_[i] += batch.velX_[i];
+			batch.posY_[i] += batch.velY_[i];
+		}
+	}
+
+	void	integrateAndBounceScalar(const MotionBatch& batch, const float width, const float height)
+	{
+		for (size_t i = 0; i < batch.count_; ++i)
+		{
+			const float x = batch.posX_[i] += batch.velX_[i];
+			const float y = batch.posY_[i] += batch.velY_[i];
+			const float r = batch.radius_[i];
+			if (x - r < 0.0f || x + r > width) { batch.velX_[i] = -batch.velX_[i]; }
+			if (y - r < 0.0f || y + r > height) { batch.velY_[i] = -batch.velY_[i]; }
+		}
+	}
+
+#if GW_X86
+	void	integrateSSE2(const MotionBatch& batch)
+	{
+		size_t i = 0;
+		for (; i + 4 <= batch.count_; i += 4)
+		{
+			_mm_storeu_ps(batch.posX_ + i, _mm_add_ps(_mm_loadu_ps(batch.posX_ + i), _mm_loadu_ps(batch.velX_ + i)));
+			_mm_storeu_ps(batch.posY_ + i, _mm_add_ps(_mm_loadu_ps(batch.posY_ + i), _mm_loadu_ps(batch.velY_ + i)));
+		}
+		integrateScalar(MotionBatch{batch.posX_ + i, batch.posY_ + i, batch.velX_ + i, batch.velY_ + i,
+									batch.radius_ + i, batch.count_ - i});
+	}
+
+	void	integrateAndBounceSSE2(const MotionBatch& batch, const float width, const float height)
+	{
+		const __m128 zero = _mm_setzero_ps();
+		const __m128 sign = _mm_set1_ps(-0.0f);
+		const __m128 maxX = _mm_set1_ps(width);
+		const __m128 maxY = _mm_set1_ps(height);
+
+		size_t i = 0;
+		for (; i + 4 <= batch.count_; i += 4)
+		{
+			const __m128 r = _mm_loadu_ps(batch.radius_ + i);
+			__m128 vx = _mm_loadu_ps(batch.velX_ + i);
+			__m128 vy = _mm_loadu_ps(batch.velY_ + i);
+			const __m128 x = _mm_add_ps(_mm_loadu_ps(batch.posX_ + i), vx);
+			const __m128 y = _mm_add_ps(_mm_loadu_ps(batch.posY_ + i), vy);
+
+			const __m128 outX = _mm_or_ps(_mm_cmplt_ps(_mm_sub_ps(x, r), zero), _mm_cmpgt_ps(_mm_add_ps(x, r), maxX));
+			const __m128 outY = _mm_or_ps(_mm_cmplt_ps(_mm_sub_ps(y, r), zero), _mm_cmpgt_ps(_mm_add_ps(y, r), maxY));
+			vx = _mm_xor_ps(vx, _mm_and_ps(outX, sign));
+			vy = _mm_xor_ps(vy, _mm_and_ps(outY, sign));
+
+			_mm_storeu_ps(batch.posX_ + i, x);
+			_mm_storeu_ps(batch.posY_ + i, y);
+			_mm_storeu_ps(batch.velX_ + i, vx);
+			_mm_storeu_ps(batch.velY_ + i, vy);
+		}
+		integrateAndBounceScalar(MotionBatch{batch.posX_ + i, batch.posY_ + i, batch.velX_ + i, batch.velY_ + i,
+												batch.radius_ + i, batch.count_ - i}, width, height);
+	}
+
+	GW_TARGET_AVX2 void	integrateAVX2(const MotionBatch& batch)
+	{
+		size_t i = 0;
+		for (; i + 8 <= batch.count_; i += 8)
+		{
+			_mm256_storeu_ps(batch.posX_ + i, _mm256_add_ps(_mm256_loadu_ps(batch.posX_ + i), _mm256_loadu_ps(batch.velX_ + i)));
+			_mm256_storeu_ps(batch.posY_ + i, _mm256_add_ps(_mm256_loadu_ps(batch.posY_ + i), _mm256_loadu_ps(batch.velY_ + i)));
+		}
+		integrateSSE2(MotionBatch{batch.posX_ + i, batch.posY_ + i, batch.velX_ + i, batch.velY_ + i,
+									batch.radius_ + i, batch.count_ - i});
+	}
+
+	GW_TARGET_AVX2 void	integrateAndBounceAVX2(const MotionBatch& batch, const float width, const float height)
+	{
+		const __m256 zero = _mm256_setzero_ps();
+		const __m256 sign = _mm256_set1_ps(-0.0f);
+		const __m256 maxX = _mm256_set1_ps(width);
+		const __m256 maxY = _mm256_set1_ps(height);
+
+		size_t i = 0;
+		for (; i + 8 <= batch.count_; i += 8)
+		{
+			const __m256 r = _mm256_loadu_ps(batch.radius_ + i);
+			__m256 vx = _mm256_loadu_ps(batch.velX_ + i);
+			__m256 vy = _mm256_loadu_ps(batch.velY_ + i);
+			const __m256 x = _mm256_add_ps(_mm256_loadu_ps(batch.posX_ + i), vx);
+			const __m256 y = _mm256_add_ps(_mm256_loadu_ps(batch.posY_ + i), vy);
+
+			const __m256 outX = _mm256_or_ps(_mm256_cmp_ps(_mm256_sub_ps(x, r), zero, _CMP_LT_OQ),
+												_mm256_cmp_ps(_mm256_add_ps(x, r), maxX, _CMP_GT_OQ));
+			const __m256 outY = _mm256_or_ps(_mm256_cmp_ps(_mm256_sub_ps(y, r), zero, _CMP_LT_OQ),
+												_mm256_cmp_ps(_mm256_add_ps(y, r), maxY, _CMP_GT_OQ));
+			vx = _mm256_xor_ps(vx, _mm256_and_ps(outX, sign));
+			vy = _mm256_xor_ps(vy, _mm256_and_ps(outY, sign));
+
+			_mm256_storeu_ps(batch.posX_ + i, x);
+			_mm256_storeu_ps(batch.posY_ + i, y);
+			_mm256_storeu_ps(batch.velX_ + i, vx);
+			_mm256_storeu_ps(batch.velY_ + i, vy);
+		}
+		integrateAndBounceSSE2(MotionBatch{batch.posX_ + i, batch.posY_ + i, batch.velX_ + i, batch.velY_ + i,
+											batch.radius_ + i, batch.count_ - i}, width, height);
+	}
+
+	bool	cpuSupportsAVX2()
+	{
+# if defined(_MSC_VER) && !defined(__clang__)
+		int info[4];
+		__cpuid(info, 0);
+		if (info[0] < 7) { return (false); }
+		__cpuid(info, 1);
+		const bool osxsave = (info[2] & (1 << 27)) != 0;
+		const bool avx = (info[2] & (1 << 28)) != 0;
+		if (!osxsave || !avx || (_xgetbv(0) & 0x6) != 0x6) { return (false); }
+		__cpuidex(info, 7, 0);
+		return ((info[1] & (1 << 5)) != 0);
+# else
+		__builtin_cpu_init();
+		return (__builtin_cpu_supports("avx2"));
+# endif
+	}
+#endif
+}
+
+void	MotionKernels::integrate(const MotionBatch& batch)
+{
+	dispatch().integrate_(batch);
+}
+
+void	MotionKernels::integrateAndBounce(const MotionBatch& batch, const float width, const float height)
+{
+	dispatch().integrateAndBounce_(batch, width, height);
+}
+
+MotionKernels::Isa	MotionKernels::detectIsa()
+{
+#if GW_X86
+	if (cpuSupportsAVX2()) { return (Isa::AVX2); }
+	return (Isa::SSE2);
+#else
+	return (Isa::Scalar);
+#endif
+}
+
+MotionKernels::Isa	MotionKernels::activeIsa() { return (dispatch().isa_); }
+
+bool	MotionKernels::setIsa(const Isa isa)
+{
+	if (static_cast<int>(isa) > static_cast<int>(detectIsa())) { return (false); }
+
+	dispatch() = makeDispatch(isa);
+
+	return (true);
+}
+
+const char*	MotionKernels::isaName(const Isa isa)
+{
+	switch (isa)
+	{
+		case Isa::SSE2:
+			return ("SSE2");
+		case Isa::AVX2:
+			return ("AVX2");
+		default:
+			return ("Scalar");
+	}
+}
+
+MotionKernels::Dispatch&	MotionKernels::dispatch()
+{
+	static Dispatch current = makeDispatch(detectIsa());
+
+	return (current);
+}
+
+MotionKernels::Dispatch	MotionKernels::makeDispatch(const Isa isa)
+{
+#if GW_X86
+	if (isa == Isa::AVX2) { return (Dispatch{isa, integrateAVX2, integrateAndBounceAVX2}); }
+	if (isa == Isa::SSE2) { return (Dispatch{isa, integrateSSE2, integrateAndBounceSSE2}); }
+#else
+	static_cast<void>(isa);
+#endif
+	return (Dispatch{Isa::Scalar, integrateScalar, integrateAndBounceScalar});
+}
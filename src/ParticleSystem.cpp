@@ -0,0 +1,80 @@
+#include "ParticleSystem.h"
+
+# include <algorithm>
+# include <cmath>
+
+ParticleSystem::ParticleSystem() :
+	random_{0x9e3779b97f4a7c15ULL, 0}
+{
+}
+
+void	ParticleSystem::reset(const size_t capacity)
+{
+	posX_.assign(capacity, 0.0f);
+	posY_.assign(capacity, 0.0f);
+	velX_.assign(capacity, 0.0f);
+	velY_.assign(capacity, 0.0f);
+	remaining_.assign(capacity, 0);
+	lifespan_.assign(capacity, 1);
+	color_.assign(capacity, sf::Color::Transparent);
+	count_ = 0;
+	dropped_ = 0;
+}
+
+void	ParticleSystem::emit(const Vec2f& pos, const Vec2f& velocity, const sf::Color color, const int lifespan)
+{
+	if (count_ == capacity() || lifespan < 1) { ++dropped_; return ; }
+
+	posX_[count_] = pos.x_;
+	posY_[count_] = pos.y_;
+	velX_[count_] = velocity.x_;
+	velY_[count_] = velocity.y_;
+	remaining_[count_] = lifespan;
+	lifespan_[count_] = lifespan;
+	color_[count_] = color;
+	++count_;
+}
+
+void	ParticleSystem::burst(const Vec2f& pos, const size_t count, const float speed, const sf::Color color, const int lifespan)
+{
+	if (capacity() == 0) { return ; }
+
+	const float step = 2.0f * 3.14159265f / std::max<size_t>(count, 1);
+	for (size_t i = 0; i < count; ++i)
+	{
+		const float angle = step * i + random_.uniform(-0.5f, 0.5f) * step;
+		const float particleSpeed = speed * random_.uniform(0.5f, 1.0f);
+		emit(pos, Vec2f{std::cos(angle), std::sin(angle)} * particleSpeed, color, lifespan);
+	}
+}
+
+// Survivors are moved down over the dead, so the arrays stay dense without a free list.
+void	ParticleSystem::update()
+{
+	size_t alive = 0;
+	for (size_t i = 0; i < count_; ++i)
+	{
+		if (--remaining_[i] < 1) { continue ; }
+
+		posX_[alive] = posX_[i] + velX_[i];
+		posY_[alive] = posY_[i] + velY_[i];
+		velX_[alive] = velX_[i];
+		velY_[alive] = velY_[i];
+		remaining_[alive] = remaining_[i];
+		lifespan_[alive] = lifespan_[i];
+		color_[alive] = color_[i];
+		++alive;
+	}
+	count_ = alive;
+}
+
+void	ParticleSystem::collect(std::vector<Instance>& out) const
+{
+	out.resize(count_);
+	for (size_t i = 0; i < count_; ++i)
+	{
+		sf::Color color = color_[i];
+		color.a = static_cast<sf::Uint8>(color.a * remaining_[i] / lifespan_[i]);
+		out[i] = Instance{Vec2f{posX_[i], posY_[i]}, Vec2f{velX_[i], velY_[i]}, color};
+	}
+}
@@ -0,0 +1,184 @@
+#include "Profiler.h"
+
+#include <nlohmann/json.hpp>
+#include <spdlog/spdlog.h>
+#include <algorithm>
+#include <fstream>
+
+namespace
+{
+	constexpr uint32_t	unassignedThread = UINT32_MAX;
+
+	thread_local uint32_t	profileThread = unassignedThread;
+
+	double	toMicroseconds(const Profiler::Clock::duration duration)
+	{
+		return (std::chrono::duration<double, std::micro>(duration).count());
+	}
+
+	float	percentile(std::vector<float>& samples, const float fraction)
+	{
+		if (samples.empty()) { return (0.0f); }
+
+		const size_t index = std::min(samples.size() - 1, static_cast<size_t>(fraction * samples.size()));
+		std::nth_element(samples.begin(), samples.begin() + index, samples.end());
+
+		return (samples[index]);
+	}
+}
+
+Profiler::State&	Profiler::state()
+{
+	static State state;
+
+	return (state);
+}
+
+uint32_t	Profiler::threadId(State& s)
+{
+	if (profileThread == unassignedThread)
+	{
+		profileThread = static_cast<uint32_t>(s.threadNames_.size());
+		s.threadNames_.emplace_back();
+	}
+
+	return (profileThread);
+}
+
+void	Profiler::beginFrame()
+{
+	if constexpr (!enabled) { return ; }
+
+	auto& s = state();
+	const std::lock_guard<std::mutex> lock{s.mutex_};
+	auto& current = s.current_;
+	current.start_ = Clock::now();
+	current.thread_ = threadId(s);
+	current.ms_.fill(0.0f);
+	for (auto& spans : current.spans_) { spans.clear(); }
+}
+
+void	Profiler::endFrame()
+{
+	if constexpr (!enabled) { return ; }
+
+	auto& s = state();
+	const std::lock_guard<std::mutex> lock{s.mutex_};
+	s.current_.end_ = Clock::now();
+	// Swap so both the ring slot and the current frame keep their span capacity.
+	std::swap(s.frames_[s.next_], s.current_);
+	s.next_ = (s.next_ + 1) % historySize;
+	s.count_ = std::min(s.count_ + 1, historySize);
+}
+
+void	Profiler::record(const ProfileZone zone, const Clock::time_point start, const Clock::time_point end)
+{
+	auto& s = state();
+	const std::lock_guard<std::mutex> lock{s.mutex_};
+	auto& current = s.current_;
+	const auto index = static_cast<size_t>(zone);
+
+	current.ms_[index] += std::chrono::duration<float, std::milli>(end - start).count();
+	current.spans_[index].push_back(Span{start, end, threadId(s)});
+}
+
+void	Profiler::setThreadName(const std::string& name)
+{
+	if constexpr (!enabled) { return ; }
+
+	auto& s = state();
+	const std::lock_guard<std::mutex> lock{s.mutex_};
+	s.threadNames_[threadId(s)] = name;
+}
+
+float	Profiler::frameMs(const Frame& frame, const ProfileZone zone)
+{
+	if (zone == ProfileZone::Count) { return (std::chrono::duration<float, std::milli>(frame.end_ - frame.start_).count()); }
+
+	return (frame.ms_[static_cast<size_t>(zone)]);
+}
+
+void	Profiler::history(const ProfileZone zone, std::vector<float>& result)
+{
+	auto& s = state();
+	const std::lock_guard<std::mutex> lock{s.mutex_};
+
+	result.clear();
+	const size_t first = (s.next_ + historySize - s.count_) % historySize;
+	for (size_t i = 0; i < s.count_; ++i) { result.push_back(frameMs(s.frames_[(first + i) % historySize], zone)); }
+}
+
+ProfileStats	Profiler::stats(const ProfileZone zone)
+{
+	std::vector<float> samples;
+	history(zone, samples);
+
+	return (stats(samples));
+}
+
+ProfileStats	Profiler::stats(std::vector<float>& samples)
+{
+	if (samples.empty()) { return (ProfileStats{}); }
+
+	ProfileStats result;
+	result.max_ = *std::max_element(samples.begin(), samples.end());
+	result.p99_ = percentile(samples, 0.99f);
+	result.p50_ = percentile(samples, 0.50f);
+
+	return (result);
+}
+
+// Chrome trace_event format: load the file in chrome://tracing or Perfetto.
+void	Profiler::writeChromeTrace(const std::string& path)
+{
+	auto& s = state();
+	std::unique_lock<std::mutex> lock{s.mutex_};
+
+	nlohmann::json events = nlohmann::json::array();
+	for (size_t thread = 0; thread < s.threadNames_.size(); ++thread)
+	{
+		if (s.threadNames_[thread].empty()) { continue ; }
+		events.push_back({{"name", "thread_name"}, {"ph", "M"}, {"pid", 0}, {"tid", thread},
+							{"args", {{"name", s.threadNames_[thread]}}}});
+	}
+	const size_t first = (s.next_ + historySize - s.count_) % historySize;
+	for (size_t i = 0; i < s.count_; ++i)
+	{
+		const Frame& frame = s.frames_[(first + i) % historySize];
+		events.push_back({{"name", "frame"}, {"ph", "X"}, {"pid", 0}, {"tid", frame.thread_},
+							{"ts", toMicroseconds(frame.start_ - s.epoch_)}, {"dur", toMicroseconds(frame.end_ - frame.start_)}});
+		for (size_t zone = 0; zone < profileZoneCount; ++zone)
+		{
+			for (const auto& span : frame.spans_[zone])
+			{
+				events.push_back({{"name", profileZoneNames[zone]}, {"ph", "X"}, {"pid", 0}, {"tid", span.thread_},
+									{"ts", toMicroseconds(span.start_ - s.epoch_)}, {"dur", toMicroseconds(span.end_ - span.start_)}});
+			}
+		}
+	}
+
+	const size_t count = s.count_;
+	lock.unlock();
+
+	std::ofstream out{path};
+	if (!out)
+	{
+		SPDLOG_ERROR("Failed to write profiler trace: {}", path);
+		return ;
+	}
+	out << nlohmann::json{{"traceEvents", events}, {"displayTimeUnit", "ms"}}.dump();
+	SPDLOG_INFO("Wrote {} profiled frames to {}", count, path);
+}
+
+void	Profiler::logSummary()
+{
+	if constexpr (!enabled) { return ; }
+
+	for (size_t zone = 0; zone < profileZoneCount; ++zone)
+	{
+		const auto zoneStats = stats(static_cast<ProfileZone>(zone));
+		if (zoneStats.max_ <= 0.0f) { continue ; }
+		SPDLOG_INFO("  {:<12} p50 {:.3f} ms  p99 {:.3f} ms  max {:.3f} ms",
+					profileZoneNames[zone], zoneStats.p50_, zoneStats.p99_, zoneStats.max_);
+	}
+}
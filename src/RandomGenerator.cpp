@@ -0,0 +1,156 @@
+#include "RandomGenerator.h"
+
+#include <algorithm>
+#include <array>
+#include <random>
+
+namespace
+{
+	struct SpawnRect
+	{
+		float	x0_;
+		float	y0_;
+		float	x1_;
+		float	y1_;
+
+		float	area() const { return (std::max(0.0f, x1_ - x0_) * std::max(0.0f, y1_ - y0_)); }
+	};
+}
+
+RandomGenerator::RandomGenerator(const uint64_t seed)
+{
+	this->seed(seed);
+}
+
+void		RandomGenerator::seed(const uint64_t seed)
+{
+	seed_ = seed;
+	position_ = RandomStream{seed, Position};
+	speed_ = RandomStream{seed, Speed};
+	color_ = RandomStream{seed, Color};
+	vertices_ = RandomStream{seed, Vertices};
+	scenario_ = RandomStream{seed, Scenario};
+}
+
+uint64_t	RandomGenerator::seed() const
+{
+	return (seed_);
+}
+
+uint64_t	RandomGenerator::entropySeed()
+{
+	std::random_device rd;
+
+	return ((static_cast<uint64_t>(rd()) << 32) | rd());
+}
+
+// Samples uniformly from the play area minus the square kept clear around the player.
+// The valid region is split into at most four rectangles, so this never loops.
+Vec2f		RandomGenerator::getRandomEnemyPos(const GameConfig& gameConfig, const Vec2f playerPos)
+{
+	const float enemyRadius = static_cast<float>(gameConfig.enemyConfig_.shapeRadius_);
+	const float playerRadius = static_cast<float>(gameConfig.playerConfig_.shapeRadius_);
+	const float clearance = playerRadius * 2.0f + enemyRadius;
+
+	const float x0 = enemyRadius + 1.0f;
+	const float y0 = enemyRadius + 1.0f;
+	const float x1 = std::max(x0, gameConfig.windowConfig_.width_ - enemyRadius - 1.0f);
+	const float y1 = std::max(y0, gameConfig.windowConfig_.height_ - enemyRadius - 1.0f);
+
+	const float ex0 = std::clamp(playerPos.x_ - clearance, x0, x1);
+	const float ex1 = std::clamp(playerPos.x_ + clearance, x0, x1);
+	const float ey0 = std::clamp(playerPos.y_ - clearance, y0, y1);
+	const float ey1 = std::clamp(playerPos.y_ + clearance, y0, y1);
+
+	const std::array<SpawnRect, 4> rects{{
+		{x0, y0, x1, ey0},
+		{x0, ey1, x1, y1},
+		{x0, ey0, ex0, ey1},
+		{ex1, ey0, x1, ey1}
+	}};
+
+	float total = 0.0f;
+	for (const auto& rect : rects) { total += rect.area(); }
+
+	if (total <= 0.0f)
+	{
+		// The clearance covers the whole play area: use the corner farthest from the player.
+		return (Vec2f{playerPos.x_ < (x0 + x1) / 2.0f ? x1 : x0, playerPos.y_ < (y0 + y1) / 2.0f ? y1 : y0});
+	}
+
+	float pick = position_.uniform(0.0f, total);
+	const SpawnRect* chosen = &rects.back();
+	for (const auto& rect : rects)
+	{
+		const float area = rect.area();
+		if (area <= 0.0f) { continue ; }
+		chosen = &rect;
+		if (pick < area) { break ; }
+		pick -= area;
+	}
+
+	return (Vec2f{position_.uniform(chosen->x0_, chosen->x1_), position_.uniform(chosen->y0_, chosen->y1_)});
+}
+
+Vec2f		RandomGenerator::getRandomEnemySpeed(const GameConfig& gameConfig)
+{
+	const float speedMin = gameConfig.enemyConfig_.speedRange_.min_;
+	const float speedMax = gameConfig.enemyConfig_.speedRange_.max_;
+
+	const float x = speed_.uniform(speedMin, speedMax);
+	const float y = speed_.uniform(speedMin, speedMax);
+
+	return (Vec2f{x, y});
+}
+
+sf::Color	RandomGenerator::getRandomEnemyColor()
+{
+	const uint32_t rgb = color_.next();
+
+	return (sf::Color{static_cast<sf::Uint8>(rgb & 0xff),
+						static_cast<sf::Uint8>((rgb >> 8) & 0xff),
+						static_cast<sf::Uint8>((rgb >> 16) & 0xff)});
+}
+
+size_t		RandomGenerator::getRandomEnemyPointCount(const GameConfig& gameConfig)
+{
+	const auto pointCountMin = static_cast<uint32_t>(gameConfig.enemyConfig_.verticeRange_.min_);
+	const auto pointCountMax = static_cast<uint32_t>(std::max(gameConfig.enemyConfig_.verticeRange_.max_,
+																gameConfig.enemyConfig_.verticeRange_.min_));
+
+	return (vertices_.uniformInt(pointCountMin, pointCountMax));
+}
+
+// Cluster positions are normal around the group center with a standard deviation
+// of spread_ times the shorter window side, clamped to the play area.
+Vec2f		RandomGenerator::getScenarioPos(const SpawnGroupConfig& group, const GameConfig& gameConfig, const float radius)
+{
+	const float width = static_cast<float>(gameConfig.windowConfig_.width_);
+	const float height = static_cast<float>(gameConfig.windowConfig_.height_);
+	const float x0 = std::min(radius, width / 2.0f);
+	const float y0 = std::min(radius, height / 2.0f);
+
+	if (group.distribution_ == SpawnDistribution::Uniform)
+	{
+		return (Vec2f{scenario_.uniform(x0, width - x0), scenario_.uniform(y0, height - y0)});
+	}
+
+	const float stddev = group.spread_ * std::min(width, height);
+	const float x = scenario_.normal(width * group.center_.x_, stddev);
+	const float y = scenario_.normal(height * group.center_.y_, stddev);
+
+	return (Vec2f{std::clamp(x, x0, width - x0), std::clamp(y, y0, height - y0)});
+}
+
+Vec2f		RandomGenerator::getScenarioVelocity(const SpawnGroupConfig& group)
+{
+	const float angle = scenario_.uniform(0.0f, 6.2831853f);
+	const float speed = scenario_.uniform(group.speedRange_.min_, std::max(group.speedRange_.min_, group.speedRange_.max_));
+
+	return (Vec2f{std::cos(angle) * speed, std::sin(angle) * speed});
+}
+
+size_t		RandomGenerator::getScenarioPointCount(const SpawnGroupConfig& group)
+{
+	return (scenario_.uniformInt(static_cast<uint32_t>(group.verticeRange_.min_), static_cast<uint32_t>(group.verticeRange_.max_)));
+}
@@ -0,0 +1,47 @@
+#include "ResourceCache.h"
+#include "AllocationCounter.h"
+
+#include <spdlog/spdlog.h>
+#include <algorithm>
+
+ResourceCache::~ResourceCache()
+{
+	if (pending_.valid()) { pending_.wait(); }
+}
+
+FontHandle	ResourceCache::requestFont(const std::string& path)
+{
+	const auto found = std::find(fontPaths_.begin(), fontPaths_.end(), path);
+	if (found != fontPaths_.end()) { return (static_cast<FontHandle>(found - fontPaths_.begin())); }
+
+	fontPaths_.push_back(path);
+	fonts_.push_back(std::make_unique<sf::Font>());
+
+	return (static_cast<FontHandle>(fontPaths_.size() - 1));
+}
+
+void	ResourceCache::loadAsync()
+{
+	pending_ = std::async(std::launch::async, [this] { return (loadFonts()); });
+}
+
+void	ResourceCache::wait()
+{
+	const bool loaded = pending_.valid() ? pending_.get() : loadFonts();
+	if (!loaded) { exit(1); }
+}
+
+bool	ResourceCache::loadFonts()
+{
+	const MemoryScope scope{MemoryTag::Sfml};
+	for (size_t i = 0; i < fontPaths_.size(); ++i)
+	{
+		if (!fonts_[i]->loadFromFile(fontPaths_[i]))
+		{
+			SPDLOG_ERROR("Could not load font: {}", fontPaths_[i]);
+			return (false);
+		}
+	}
+
+	return (true);
+}
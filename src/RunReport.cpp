@@ -0,0 +1,212 @@
+#include "RunReport.h"
+
+#include <nlohmann/json.hpp>
+#include <spdlog/spdlog.h>
+#include <algorithm>
+#include <fstream>
+#include <numeric>
+
+#ifdef _WIN32
+# define NOMINMAX
+# include <windows.h>
+# include <psapi.h>
+#else
+# include <sys/resource.h>
+#endif
+
+void	RunReport::addFrame(const float ms, const size_t entities, const size_t poolBytes, const uint64_t allocations)
+{
+	const int steadyStateFrame = scenario_.steadyStateFrame_;
+	if (steadyStateFrame >= 0 && frameMs_.size() >= static_cast<size_t>(steadyStateFrame) && allocations > 0) { ++allocatingFrames_; }
+	allocations_ += allocations;
+	maxFrameAllocations_ = std::max(maxFrameAllocations_, allocations);
+	frameMs_.push_back(ms);
+	peakEntities_ = std::max(peakEntities_, entities);
+	peakPoolBytes_ = std::max(peakPoolBytes_, poolBytes);
+}
+
+RunSummary	RunReport::summarize() const
+{
+	RunSummary summary;
+	summary.peakEntities_ = peakEntities_;
+	summary.peakPoolBytes_ = peakPoolBytes_;
+	summary.peakResidentBytes_ = peakResidentBytes();
+	summary.allocations_ = allocations_;
+	summary.maxFrameAllocations_ = maxFrameAllocations_;
+	summary.allocatingFrames_ = allocatingFrames_;
+	for (size_t tag = 0; tag < memoryTagCount; ++tag) { summary.memory_[tag] = AllocationCounter::stats(static_cast<MemoryTag>(tag)); }
+	summary.memoryTotal_ = AllocationCounter::total();
+	if (frameMs_.empty()) { return (summary); }
+
+	std::vector<float> sorted{frameMs_};
+	std::sort(sorted.begin(), sorted.end());
+	const auto at = [&sorted](const float fraction)
+	{
+		return (sorted[std::min(sorted.size() - 1, static_cast<size_t>(fraction * sorted.size()))]);
+	};
+
+	summary.frames_ = sorted.size();
+	summary.meanMs_ = std::accumulate(sorted.begin(), sorted.end(), 0.0f) / sorted.size();
+	summary.p50Ms_ = at(0.50f);
+	summary.p99Ms_ = at(0.99f);
+	summary.maxMs_ = sorted.back();
+	const float budgetMs = scenario_.frameBudgetMs_;
+	if (budgetMs > 0.0f)
+	{
+		summary.overBudget_ = static_cast<size_t>(sorted.end() - std::upper_bound(sorted.begin(), sorted.end(), budgetMs));
+	}
+
+	return (summary);
+}
+
+bool	RunReport::withinFrameBudget(const RunSummary& summary) const
+{
+	return (scenario_.frameBudgetMs_ <= 0.0f || summary.p99Ms_ <= scenario_.frameBudgetMs_);
+}
+
+bool	RunReport::withinMemoryBudget(const RunSummary& summary) const
+{
+	if constexpr (!AllocationCounter::tracking) { return (true); }
+
+	for (size_t tag = 0; tag < memoryTagCount; ++tag)
+	{
+		const size_t budget = scenario_.memoryBudgets_[tag];
+		if (budget > 0 && summary.memory_[tag].peakBytes_ > budget) { return (false); }
+	}
+
+	return (scenario_.memoryBudgetTotal_ == 0 || summary.memoryTotal_.peakBytes_ <= scenario_.memoryBudgetTotal_);
+}
+
+void	RunReport::log(const RunSummary& summary) const
+{
+	constexpr double mib = 1024.0 * 1024.0;
+	const std::string& name = scenario_.name_;
+
+	SPDLOG_INFO("Scenario {}: {} frames, mean {:.3f} ms, p50 {:.3f} ms, p99 {:.3f} ms, max {:.3f} ms",
+				name, summary.frames_, summary.meanMs_, summary.p50Ms_, summary.p99Ms_, summary.maxMs_);
+	SPDLOG_INFO("Scenario {}: peak {} entities, entity pool {:.1f} MiB, peak resident {:.1f} MiB",
+				name, summary.peakEntities_, summary.peakPoolBytes_ / mib, summary.peakResidentBytes_ / mib);
+	if (AllocationCounter::enabled)
+	{
+		SPDLOG_INFO("Scenario {}: {} heap allocations during ticks ({:.1f} per tick, at most {})", name, summary.allocations_,
+					summary.frames_ > 0 ? static_cast<double>(summary.allocations_) / summary.frames_ : 0.0,
+					summary.maxFrameAllocations_);
+	}
+	else if (scenario_.steadyStateFrame_ >= 0)
+	{
+		SPDLOG_WARN("Scenario {}: the steady-state check needs -DGEOMETRY_WARS_COUNT_ALLOCATIONS=ON or a Debug build and was not done", name);
+	}
+	if (summary.allocatingFrames_ > 0)
+	{
+		SPDLOG_ERROR("Scenario {}: {} frames allocated after steady-state frame {}", name, summary.allocatingFrames_,
+						scenario_.steadyStateFrame_);
+	}
+	logMemory(summary);
+
+	const float budgetMs = scenario_.frameBudgetMs_;
+	if (budgetMs <= 0.0f) { return ; }
+
+	if (withinFrameBudget(summary))
+	{
+		SPDLOG_INFO("Scenario {}: within the {:.3f} ms budget ({} frames over)", name, budgetMs, summary.overBudget_);
+	}
+	else
+	{
+		SPDLOG_ERROR("Scenario {}: p99 {:.3f} ms exceeds the {:.3f} ms budget ({} frames over)",
+						name, summary.p99Ms_, budgetMs, summary.overBudget_);
+	}
+}
+
+void	RunReport::logMemory(const RunSummary& summary) const
+{
+	constexpr double kib = 1024.0;
+	const std::string& name = scenario_.name_;
+	const bool budgeted = scenario_.memoryBudgetTotal_ > 0
+						|| std::any_of(scenario_.memoryBudgets_.begin(), scenario_.memoryBudgets_.end(), [](const size_t budget) { return (budget > 0); });
+	if constexpr (!AllocationCounter::tracking)
+	{
+		if (budgeted) { SPDLOG_WARN("Scenario {}: memory budgets need -DGEOMETRY_WARS_TRACK_MEMORY=ON and were not checked", name); }
+		return ;
+	}
+
+	for (size_t tag = 0; tag <= memoryTagCount; ++tag)
+	{
+		const bool total = tag == memoryTagCount;
+		const auto& memory = total ? summary.memoryTotal_ : summary.memory_[tag];
+		const size_t budget = total ? scenario_.memoryBudgetTotal_ : scenario_.memoryBudgets_[tag];
+		const char* tagName = total ? "total" : memoryTagNames[tag];
+		SPDLOG_INFO("Scenario {}: memory {:<8} {} allocations since startup, {:.1f} KiB live, {:.1f} KiB peak",
+					name, tagName, memory.allocations_, memory.liveBytes_ / kib, memory.peakBytes_ / kib);
+		if (budget > 0 && memory.peakBytes_ > budget)
+		{
+			SPDLOG_ERROR("Scenario {}: {} peak {:.1f} KiB exceeds the {:.1f} KiB budget", name, tagName, memory.peakBytes_ / kib, budget / kib);
+		}
+	}
+}
+
+bool	RunReport::write(const std::string& path, const RunSummary& summary) const
+{
+	using json = nlohmann::json;
+
+	// "allocations" counts what the measured ticks allocated; memory covers the whole process.
+	const auto memoryJson = [](const MemoryStats& memory, const size_t budget)
+	{
+		return (json{{"allocationsSinceStartup", memory.allocations_}, {"liveBytes", memory.liveBytes_},
+					{"peakBytes", memory.peakBytes_}, {"budgetBytes", budget}});
+	};
+	json memory = {{"tracked", AllocationCounter::tracking}};
+	if (AllocationCounter::tracking)
+	{
+		for (size_t tag = 0; tag < memoryTagCount; ++tag)
+		{
+			memory["tags"][memoryTagNames[tag]] = memoryJson(summary.memory_[tag], scenario_.memoryBudgets_[tag]);
+		}
+		memory["total"] = memoryJson(summary.memoryTotal_, scenario_.memoryBudgetTotal_);
+	}
+
+	const json report = {
+		{"scenario", scenario_.name_},
+		{"frames", summary.frames_},
+		{"frameMs", {{"mean", summary.meanMs_}, {"p50", summary.p50Ms_}, {"p99", summary.p99Ms_}, {"max", summary.maxMs_},
+						{"budget", scenario_.frameBudgetMs_}, {"overBudget", summary.overBudget_}}},
+		{"peakEntities", summary.peakEntities_},
+		{"peakPoolBytes", summary.peakPoolBytes_},
+		{"peakResidentBytes", summary.peakResidentBytes_},
+		{"allocations", {{"counted", AllocationCounter::enabled}, {"duringTicks", summary.allocations_},
+							{"perTick", summary.frames_ > 0 ? static_cast<double>(summary.allocations_) / summary.frames_ : 0.0},
+							{"maxPerTick", summary.maxFrameAllocations_}, {"steadyStateFrame", scenario_.steadyStateFrame_},
+							{"allocatingFrames", summary.allocatingFrames_}}},
+		{"memory", memory},
+		{"withinBudget", withinBudget(summary)}
+	};
+
+	std::ofstream out{path};
+	if (!out)
+	{
+		SPDLOG_ERROR("Failed to open run report for writing: {}", path);
+		return (false);
+	}
+	out << report.dump(1, '\t') << '\n';
+	SPDLOG_INFO("Wrote run report to {}", path);
+
+	return (static_cast<bool>(out));
+}
+
+size_t	RunReport::peakResidentBytes()
+{
+#ifdef _WIN32
+	PROCESS_MEMORY_COUNTERS counters;
+	if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) { return (0); }
+
+	return (counters.PeakWorkingSetSize);
+#else
+	rusage usage{};
+	if (getrusage(RUSAGE_SELF, &usage) != 0) { return (0); }
+
+# ifdef __APPLE__
+	return (static_cast<size_t>(usage.ru_maxrss));
+# else
+	return (static_cast<size_t>(usage.ru_maxrss) * 1024);
+# endif
+#endif
+}
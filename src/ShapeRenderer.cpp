@@ -0,0 +1,114 @@
+#include "ShapeRenderer.h"
+
+# include <cmath>
+
+ShapeRenderer::ShapeRenderer() :
+	vertices_{sf::Triangles}
+{
+	// Enemies use 3-8 vertices and bullets 20; build those up front.
+	for (size_t pointCount = 3; pointCount <= 8; ++pointCount) { unitPolygon(pointCount); }
+	unitPolygon(20);
+}
+
+void	ShapeRenderer::clear()
+{
+	vertices_.clear();
+}
+
+void	ShapeRenderer::add(const Vec2f& pos, const float angle, const ShapeComponent& shape)
+{
+	if (shape.pointCount_ < 3) { return ; }
+
+	const auto& unit = unitPolygon(shape.pointCount_);
+	const size_t count = unit.size();
+
+	const float pi = 3.14159265f;
+	const float radians = angle * pi / 180.0f;
+	const float cosAngle = std::cos(radians);
+	const float sinAngle = std::sin(radians);
+
+	// Same geometry as sf::CircleShape: the outline grows outwards and each
+	// corner is mitred, which for a regular polygon is thickness / cos(pi / n).
+	const float inner = shape.radius_;
+	const float outer = shape.radius_ + shape.outlineThickness_ / std::cos(pi / count);
+	const sf::Vector2f center{pos.x_, pos.y_};
+	auto corner = [&](const size_t i, const float radius)
+	{
+		const auto& dir = unit[i % count];
+		return (sf::Vector2f{center.x + (dir.x * cosAngle - dir.y * sinAngle) * radius,
+								center.y + (dir.x * sinAngle + dir.y * cosAngle) * radius});
+	};
+
+	for (size_t i = 0; i < count; ++i)
+	{
+		vertices_.append(sf::Vertex{center, shape.fillColor_});
+		vertices_.append(sf::Vertex{corner(i, inner), shape.fillColor_});
+		vertices_.append(sf::Vertex{corner(i + 1, inner), shape.fillColor_});
+	}
+
+	if (shape.outlineThickness_ == 0.0f) { return ; }
+
+	for (size_t i = 0; i < count; ++i)
+	{
+		const sf::Vector2f innerA = corner(i, inner);
+		const sf::Vector2f innerB = corner(i + 1, inner);
+		const sf::Vector2f outerA = corner(i, outer);
+		const sf::Vector2f outerB = corner(i + 1, outer);
+
+		vertices_.append(sf::Vertex{innerA, shape.outlineColor_});
+		vertices_.append(sf::Vertex{outerA, shape.outlineColor_});
+		vertices_.append(sf::Vertex{innerB, shape.outlineColor_});
+		vertices_.append(sf::Vertex{innerB, shape.outlineColor_});
+		vertices_.append(sf::Vertex{outerA, shape.outlineColor_});
+		vertices_.append(sf::Vertex{outerB, shape.outlineColor_});
+	}
+}
+
+void	ShapeRenderer::addStreak(const Vec2f& head, const Vec2f& tail, const sf::Color color, const float width)
+{
+	const float dx = head.x_ - tail.x_;
+	const float dy = head.y_ - tail.y_;
+	const float length = std::sqrt(dx * dx + dy * dy);
+	if (length == 0.0f) { return ; }
+
+	const sf::Vector2f side{-dy / length * width * 0.5f, dx / length * width * 0.5f};
+	const sf::Color faded{color.r, color.g, color.b, 0};
+	const sf::Vertex headA{sf::Vector2f{head.x_ + side.x, head.y_ + side.y}, color};
+	const sf::Vertex headB{sf::Vector2f{head.x_ - side.x, head.y_ - side.y}, color};
+	const sf::Vertex tailA{sf::Vector2f{tail.x_ + side.x, tail.y_ + side.y}, faded};
+	const sf::Vertex tailB{sf::Vector2f{tail.x_ - side.x, tail.y_ - side.y}, faded};
+
+	vertices_.append(headA);
+	vertices_.append(headB);
+	vertices_.append(tailA);
+	vertices_.append(tailA);
+	vertices_.append(headB);
+	vertices_.append(tailB);
+}
+
+void	ShapeRenderer::draw(sf::RenderTarget& target) const
+{
+	if (vertices_.getVertexCount() == 0) { return ; }
+
+	target.draw(vertices_);
+}
+
+const std::vector<sf::Vector2f>&	ShapeRenderer::unitPolygon(const size_t pointCount)
+{
+	if (unitPolygons_.size() <= pointCount) { unitPolygons_.resize(pointCount + 1); }
+
+	auto& unit = unitPolygons_[pointCount];
+	if (unit.empty())
+	{
+		// Points start at the top like sf::CircleShape::getPoint.
+		const float pi = 3.14159265f;
+		unit.reserve(pointCount);
+		for (size_t i = 0; i < pointCount; ++i)
+		{
+			const float angle = i * 2.0f * pi / pointCount - pi / 2.0f;
+			unit.emplace_back(std::cos(angle), std::sin(angle));
+		}
+	}
+
+	return (unit);
+}
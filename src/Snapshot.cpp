@@ -0,0 +1,56 @@
+#include "Snapshot.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+
+void	SnapshotRing::reset(const size_t capacity)
+{
+	slots_.assign(capacity, std::vector<char>{});
+	next_ = 0;
+	count_ = 0;
+}
+
+std::vector<char>&	SnapshotRing::push()
+{
+	auto& slot = slots_[next_];
+	next_ = (next_ + 1) % slots_.size();
+	count_ = std::min(count_ + 1, slots_.size());
+
+	return (slot);
+}
+
+void	SnapshotRing::drop(const size_t age)
+{
+	const size_t dropped = std::min(age, count_);
+	if (dropped == 0) { return ; }
+
+	next_ = (next_ + slots_.size() - dropped) % slots_.size();
+	count_ -= dropped;
+}
+
+size_t	SnapshotRing::bytes() const
+{
+	size_t total = 0;
+	for (const auto& slot : slots_) { total += slot.capacity(); }
+
+	return (total);
+}
+
+bool	writeSnapshotFile(const std::string& path, const std::vector<char>& data)
+{
+	std::ofstream out{path, std::ios::binary};
+	out.write(data.data(), static_cast<std::streamsize>(data.size()));
+
+	return (static_cast<bool>(out));
+}
+
+bool	readSnapshotFile(const std::string& path, std::vector<char>& data)
+{
+	std::ifstream in{path, std::ios::binary};
+	if (!in) { return (false); }
+
+	data.assign(std::istreambuf_iterator<char>{in}, std::istreambuf_iterator<char>{});
+
+	return (true);
+}
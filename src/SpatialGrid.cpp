@@ -0,0 +1,75 @@
+#include "SpatialGrid.h"
+
+# include <algorithm>
+# include <cmath>
+
+void	SpatialGrid::reset(const float width, const float height, const float cellSize)
+{
+	invCellSize_ = 1.0f / cellSize;
+	columns_ = std::max(1, static_cast<int>(std::ceil(width * invCellSize_)));
+	rows_ = std::max(1, static_cast<int>(std::ceil(height * invCellSize_)));
+
+	pending_.clear();
+	cellStart_.assign(cellCount() + 1, 0);
+	cellItems_.clear();
+}
+
+void	SpatialGrid::insert(const uint32_t item, const Vec2f& pos, const float radius)
+{
+	const CellRange range = cellRange(pos, radius);
+	for (int y = range.minY_; y <= range.maxY_; ++y)
+	{
+		for (int x = range.minX_; x <= range.maxX_; ++x)
+		{
+			pending_.emplace_back(static_cast<uint32_t>(y * columns_ + x), item);
+		}
+	}
+}
+
+void	SpatialGrid::build()
+{
+	for (const auto& [cell, item] : pending_) { ++cellStart_[cell + 1]; }
+	for (size_t cell = 1; cell < cellStart_.size(); ++cell) { cellStart_[cell] += cellStart_[cell - 1]; }
+
+	// Scatter with a running cursor per cell; keeps insertion order inside each cell.
+	cellItems_.resize(pending_.size());
+	cellCursor_.assign(cellStart_.begin(), cellStart_.end() - 1);
+	for (const auto& [cell, item] : pending_) { cellItems_[cellCursor_[cell]++] = item; }
+}
+
+void	SpatialGrid::query(const Vec2f& pos, const float radius, std::vector<uint32_t>& result) const
+{
+	result.clear();
+
+	const CellRange range = cellRange(pos, radius);
+	for (int y = range.minY_; y <= range.maxY_; ++y)
+	{
+		for (int x = range.minX_; x <= range.maxX_; ++x)
+		{
+			const size_t cell = static_cast<size_t>(y) * columns_ + x;
+			result.insert(result.end(), cellItems_.begin() + cellStart_[cell], cellItems_.begin() + cellStart_[cell + 1]);
+		}
+	}
+
+	if (range.minX_ != range.maxX_ || range.minY_ != range.maxY_)
+	{
+		std::sort(result.begin(), result.end());
+		result.erase(std::unique(result.begin(), result.end()), result.end());
+	}
+}
+
+SpatialGrid::CellRange	SpatialGrid::cellRange(const Vec2f& pos, const float radius) const
+{
+	return (CellRange{clampColumn(pos.x_ - radius), clampRow(pos.y_ - radius),
+						clampColumn(pos.x_ + radius), clampRow(pos.y_ + radius)});
+}
+
+int		SpatialGrid::clampColumn(const float x) const
+{
+	return (std::clamp(static_cast<int>(std::floor(x * invCellSize_)), 0, columns_ - 1));
+}
+
+int		SpatialGrid::clampRow(const float y) const
+{
+	return (std::clamp(static_cast<int>(std::floor(y * invCellSize_)), 0, rows_ - 1));
+}
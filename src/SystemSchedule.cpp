@@ -0,0 +1,44 @@
+#include "SystemSchedule.h"
+
+void	SystemSchedule::add(const std::string& name, const SystemAccess& access, std::function<void()> system)
+{
+	systems_.push_back(System{name, access, system});
+
+	bool fits = !stages_.empty();
+	if (fits)
+	{
+		for (const auto index : stages_.back().systems_)
+		{
+			if (systems_[index].access_.conflictsWith(access)) { fits = false; break ; }
+		}
+	}
+	if (!fits) { stages_.emplace_back(); }
+
+	stages_.back().systems_.push_back(systems_.size() - 1);
+	stages_.back().tasks_.push_back(std::move(system));
+}
+
+void	SystemSchedule::run(JobSystem& jobs) const
+{
+	for (const auto& stage : stages_)
+	{
+		if (stage.tasks_.size() == 1) { stage.tasks_.front()(); }
+		else { jobs.parallelInvoke(stage.tasks_); }
+	}
+}
+
+std::string	SystemSchedule::describe() const
+{
+	std::string description;
+	for (const auto& stage : stages_)
+	{
+		description += description.empty() ? "[" : " [";
+		for (size_t i = 0; i < stage.systems_.size(); ++i)
+		{
+			description += (i == 0 ? "" : " | ") + systems_[stage.systems_[i]].name_;
+		}
+		description += "]";
+	}
+
+	return (description);
+}
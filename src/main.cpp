@@ -1,10 +1,9 @@
 #include "Game.h"
+#include "CommandLine.h"
 
-int main(void)
+int main(int argc, char** argv)
 {
-	Game game{"config.json"};
+	Game game{CommandLine::parse(argc, argv)};
 
-	game.run();
-	
-	return (0);
+	return (game.run());
 }
\ No newline at end of file